@@ -1,37 +1,60 @@
 //MORITZ ZIDECK
 
-#include <winsock2.h>
-#include <ws2tcpip.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <conio.h>
 #include <unistd.h>
 #include <string.h>
 #include "cJSON.h"
 #include <sys/time.h>
-#include <windows.h>
 #include "math.h"
+#include "sockets.h"
+#ifdef POSIX_BACKEND
+#include <poll.h>
+#define _popen popen
+#define _pclose pclose
+#endif
 
 #include "json_utils.h"
 #include "socket_utils.h"
+#include "item_handle.h"
+#include "board_trace.h"
+#include "comm_stats.h"
 #include "vlitem_handler.h"
 #include "logz.h"
 #include "common_utils.h"
 #include "axis_controller.h"
+#include "transport.h"
+#include "periodic_executor.h"
+#include "process_image.h"
+#include "bit_watcher.h"
+#include "sysid_readout.h"
 
 
 //thread global variable
 __thread int axleNum;
-__thread SOCKET clientSocket;
 __thread char axleIPAdress[16];
 __thread int axlePort;
 
+#ifdef POSIX_BACKEND
+// There is no asynchronous key state on a terminal, 'q' has to be confirmed with enter
+int kbhit() {
+    struct pollfd input = { STDIN_FILENO, POLLIN, 0 };
+    char key;
+    while (poll(&input, 1, 0) == 1 && (input.revents & POLLIN) && read(STDIN_FILENO, &key, 1) == 1) {
+        if (key == 'q' || key == 'Q') {
+            return 1;
+        }
+    }
+    return 0;
+}
+#else
 int kbhit() {
     if ((GetAsyncKeyState('q') & 0x8001) || (GetAsyncKeyState('Q') & 0x8001)) {
         return 1;
     }
     return 0;
 }
+#endif
 
 int visualiseGraph(char *fileName) {
     FILE *gnupipe = NULL;
@@ -48,21 +71,21 @@ int visualiseGraph(char *fileName) {
     return 0;
 }
 
-int readPosFromBoard(SOCKET socket,char* item, double* angle){
+int readPosFromBoard(BoardConnection *connection,char* item, double* angle){
 	int32_t readValue;
 	float fval;
-	VLItem vlitem;
-	if(getVLItem(&vlitem,item)==1){
+	VLItem *vlitem;
+	if(getVLItem(connection, &vlitem,item)==1){
 		return 1;
 	}
-	if(vlitem.LenTyp[0]==10){
-		if(readFromBoardInt32(socket, item, &readValue)==1){
+	if(vlitem->LenTyp[0]==10){
+		if(readFromBoardInt32(connection, item, &readValue)==1){
 			fprintf(stderr,"Reading %s from Board failed",item);
 			fflush(stderr);
 			return 1;
 		}
-	}else if(vlitem.LenTyp[0]==12){
-		if(readFromBoardFloat(socket, item, &fval)==1){
+	}else if(vlitem->LenTyp[0]==12){
+		if(readFromBoardFloat(connection, item, &fval)==1){
 			fprintf(stderr,"Reading %s from Board failed",item);
 			fflush(stderr);
 			return 1;
@@ -81,450 +104,708 @@ int readPosFromBoard(SOCKET socket,char* item, double* angle){
 	return 0;
 }
 
-void startMotor(SOCKET *clientSocket){
+void startMotor(BoardConnection *connection){
 
-	writeToBoard(*clientSocket,"state_2.motionmode",0);
-	writeToBoard(*clientSocket,"state_1.motionmode",0);
-	writeToBoard(*clientSocket,"state_1.run",0);
-	writeToBoard(*clientSocket,"state_2.run",0);
+	writeToBoard(connection,"state_2.motionmode",0);
+	writeToBoard(connection,"state_1.motionmode",0);
+	writeToBoard(connection,"state_1.run",0);
+	writeToBoard(connection,"state_2.run",0);
 	printf("Start\n");
-//	clearBoardBitItems(*clientSocket, "errorAction_1");
-//	clearBoardBitItems(*clientSocket, "errorAction_2");
+//	clearBoardBitItems(connection, "errorAction_1");
+//	clearBoardBitItems(connection, "errorAction_2");
 //	sleep_us(800000);
-	writeToBoard(*clientSocket,"peripherial.aux",1);
-	writeToBoard(*clientSocket,"state_2.motionmode",2);
-	writeToBoard(*clientSocket,"state_1.motionmode",2);
-	writeToBoard(*clientSocket,"state_2.motionmode",2);
-	writeToBoard(*clientSocket,"state_1.motionmode",2);
+	writeToBoard(connection,"peripherial.aux",1);
+	writeToBoard(connection,"state_2.motionmode",2);
+	writeToBoard(connection,"state_1.motionmode",2);
+	writeToBoard(connection,"state_2.motionmode",2);
+	writeToBoard(connection,"state_1.motionmode",2);
 	//sleep_us(200000);
-	writeToBoard(*clientSocket,"state_2.run",1);
-	writeToBoard(*clientSocket,"state_2.run",1);
+	writeToBoard(connection,"state_2.run",1);
+	writeToBoard(connection,"state_2.run",1);
 
 }
 
-uint32_t toggleTrajectorySYSID(SOCKET *clientSocket, float vel, double pos_start, double pos_end, uint32_t busyFlag, uint32_t doneFlag){
+// State of the sysid trajectory loop, the axle is moved back and forth while the board measures
+typedef struct
+{
+	BoardConnection *connection;
+	ProcessImage image;			// position, done and busy flag, refreshed by the poller of the process image
+	int pos2Index;
+	int doneIndex;
+	int busyIndex;
+	ItemHandle *velTarg2;
+	ItemHandle *run2;
+	ItemHandle *resetBit;
+	float velpos;
+	float velneg;
+	double pos_start;
+	double pos_end;
+	double limit_start;
+	double limit_end;
 	int32_t pos2;
-	float velpos= vel;
-	float velneg= -vel;
+	int print_ctr;
+	int send_ctr_end;
+	int send_ctr_start;
+	int checkFlag_timer;
+	uint32_t busyFlag;
+	uint32_t doneFlag;
+	uint32_t result;
+} SysidTrajectory;
+
+static int sysidTrajectoryCycle(void *userData){
+	SysidTrajectory *loop = userData;
 	int32_t calcValue;
 	double angle;
 	double incToDec;
-	int print_ctr = 0;
-	int send_ctr_end = 0;
-	int send_ctr_start = 0;
-	int checkFlag_timer = 0;
+	ProcessImageSnapshot snapshot;
+
+	if (kbhit()){
+		lockBoardConnection(loop->connection);
+		writeItemFloat(loop->connection,loop->velTarg2,0);
+		writeItem(loop->connection,loop->run2,0);
+		writeItem(loop->connection, loop->resetBit, 1);
+		writeItem(loop->connection, loop->resetBit, 1);
+		unlockBoardConnection(loop->connection);
+		loop->result = 0;
+		return 1;
+	}
+
+	int checkFlags = loop->checkFlag_timer > 100;
+	int refreshed = readProcessImage(&loop->image, &snapshot) == 0;
+	if(refreshed && snapshot.status[loop->pos2Index] == 0){
+		loop->pos2 = (int32_t) snapshot.values[loop->pos2Index];
+	}
+	calcValue = loop->pos2 & 0x3FFFFFFF;
+	incToDec = 360.0 / pow(2, 30);
+	angle = (double)calcValue * incToDec;
+
+	if(loop->print_ctr > 33){
+		printf("%.1f\n",angle);
+		loop->print_ctr = 0;
+	}
+
+	if(angle >= loop->pos_end && angle <= loop->limit_end){
+		if(loop->send_ctr_start < 6){
+			printf("Send negative vel_targ\n");
+			lockBoardConnection(loop->connection);
+			writeItemFloat(loop->connection,loop->velTarg2,loop->velneg);
+			unlockBoardConnection(loop->connection);
+			loop->send_ctr_start++;
+			loop->send_ctr_end=0;
+		}
+	}
+	if(angle <= loop->pos_start && angle >= loop->limit_start){
+		if(loop->send_ctr_end < 6){
+			printf("Send positive vel_targ\n");
+			lockBoardConnection(loop->connection);
+			writeItemFloat(loop->connection,loop->velTarg2,loop->velpos);
+			unlockBoardConnection(loop->connection);
+			loop->send_ctr_end++;
+			loop->send_ctr_start=0;
+		}
+	}
+
+	// the flags are checked every cycle, they cost no round trip anymore, but only printed every second
+	if(refreshed && snapshot.status[loop->doneIndex] == 0 && snapshot.status[loop->busyIndex] == 0){
+		loop->doneFlag = snapshot.values[loop->doneIndex];
+		loop->busyFlag = snapshot.values[loop->busyIndex];
+	}
+	if(checkFlags){
+		printf("DoneFlag: %d\n",loop->doneFlag);
+		printf("BusyFlag: %d\n",loop->busyFlag);
+		fflush(stdout);
+		loop->checkFlag_timer=0;
+	}
+	if(loop->doneFlag==1){
+		loop->result = 1;
+		return 1;
+	}
+	loop->print_ctr++;
+	loop->checkFlag_timer++;
+	return 0;
+}
+
+uint32_t toggleTrajectorySYSID(BoardConnection *connection, float vel, double pos_start, double pos_end, uint32_t busyFlag, uint32_t doneFlag){
+	SysidTrajectory loop = {
+		.connection = connection,
+		.velpos = vel,
+		.velneg = -vel,
+		.pos_start = pos_start,
+		.pos_end = pos_end,
+		.busyFlag = busyFlag,
+		.doneFlag = doneFlag
+	};
+	PeriodicExecutor executor;
 
 	// ----- limit values in degrees | change value for toggle path here -----
 //	pos_start = 290;
 //	pos_end = 180;
-	double limit_start = 270;
-	double limit_end = 260;
+	loop.limit_start = 270;
+	loop.limit_end = 260;
 	// -----------------------------------------------------------------------
 
-	writeToBoardFloat(*clientSocket,"vel_targ_2", vel);
+	// position and sysid flags are read by the process image, the loop itself only writes
+	initProcessImage(&loop.image, connection, PROCESS_IMAGE_PERIOD_NS);
+	if(subscribeItem(&loop.image, "pos_2", &loop.pos2Index) == 1
+			|| subscribeItem(&loop.image, "sysid_status.doneFlag", &loop.doneIndex) == 1
+			|| subscribeItem(&loop.image, "sysid_status.busyFlag", &loop.busyIndex) == 1
+			|| resolveItem(connection, "vel_targ_2", &loop.velTarg2) == 1
+			|| resolveItem(connection, "state_2.run", &loop.run2) == 1
+			|| resolveItem(connection, "sysid_control.resetBit", &loop.resetBit) == 1){
+		fprintf(stderr,"Resolving the trajectory items failed\n");
+		releaseProcessImage(&loop.image);
+		releaseItem(loop.velTarg2);
+		releaseItem(loop.run2);
+		releaseItem(loop.resetBit);
+		return 0;
+	}
 
-	while(1){
+	writeItemFloat(connection,loop.velTarg2, vel);
 
-		if (kbhit()){
-			writeToBoardFloat(*clientSocket,"vel_targ_2",0);
-			writeToBoard(*clientSocket,"state_2.run",0);
-			writeToBoard(*clientSocket, "sysid_control.resetBit", 1);
-			writeToBoard(*clientSocket, "sysid_control.resetBit", 1);
-			//break;
-			return 0;
-		}
+	if(startProcessImage(&loop.image) == 1){
+		releaseProcessImage(&loop.image);
+		releaseItem(loop.velTarg2);
+		releaseItem(loop.run2);
+		releaseItem(loop.resetBit);
+		return 0;
+	}
+	initPeriodicExecutor(&executor, "sysid trajectory", MOTION_LOOP_PERIOD_NS, sysidTrajectoryCycle, &loop);
+	runPeriodicExecutor(&executor);
+	stopProcessImage(&loop.image);
+	dumpPeriodicStats(&executor, stdout);
+	dumpPeriodicStats(&loop.image.executor, stdout);
+
+	releaseProcessImage(&loop.image);
+	releaseItem(loop.velTarg2);
+	releaseItem(loop.run2);
+	releaseItem(loop.resetBit);
+	return loop.result;
+}
 
-		readFromBoardInt32(*clientSocket, "pos_2", &pos2);
-		sleep_us(10000);
-		calcValue = pos2 & 0x3FFFFFFF;
-		incToDec = 360.0 / pow(2, 30);
-		angle = (double)calcValue * incToDec;
 
-		if(print_ctr > 33){
-			printf("%.1f\n",angle);
-			print_ctr = 0;
-		}
+// Waits for the done flag of the sweep, the flags are printed every second. Returns 1 if it was aborted by a key.
+static int waitForSweep(BoardConnection *connection){
+	BitWatcher watcher;
+	int doneIndex;
+	int busyIndex;
+	uint32_t doneFlag = 0;
+	uint32_t busyFlag = 0;
+	int done = 0;
+	int aborted = 0;
 
-		if(angle >= pos_end && angle <= limit_end){
-			if(send_ctr_start < 6){
-				printf("Send negative vel_targ\n");
-				writeToBoardFloat(*clientSocket,"vel_targ_2",velneg);
-				send_ctr_start++;
-				send_ctr_end=0;
-			}
-		}
-		if(angle <= pos_start && angle >= limit_start){
-			if(send_ctr_end < 6){
-				printf("Send positive vel_targ\n");
-				writeToBoardFloat(*clientSocket,"vel_targ_2",velpos);
-				send_ctr_end++;
-				send_ctr_start=0;
-			}
-		}
+	if(initBitWatcher(&watcher, connection, BIT_WATCH_PERIOD_NS) == 1){
+		fprintf(stderr,"Watching the sysid flags failed\n");
+		return 1;
+	}
+	if(watchItem(&watcher, "sysid_status.doneFlag", &doneIndex) == 1
+			|| watchItem(&watcher, "sysid_status.busyFlag", &busyIndex) == 1
+			|| startBitWatcher(&watcher) == 1){
+		fprintf(stderr,"Watching the sysid flags failed\n");
+		releaseBitWatcher(&watcher);
+		return 1;
+	}
+	// wakes within a poll period of the watcher after the board set the done flag
+	while(!done && !aborted){
+		done = waitForValue(&watcher, doneIndex, 1, 1000000000ULL) == 0;
+		getWatchedValue(&watcher, doneIndex, &doneFlag);
+		getWatchedValue(&watcher, busyIndex, &busyFlag);
+		printf("DoneFlag: %d\n",doneFlag);
+		printf("BusyFlag: %d\n\n",busyFlag);
+		fflush(stdout);
+		aborted = !done && kbhit();
+	}
+	releaseBitWatcher(&watcher);
 
-		if(checkFlag_timer > 100){
-			readFromBoardBitItem(*clientSocket,"sysid_status.doneFlag",&doneFlag);
-			readFromBoardBitItem(*clientSocket,"sysid_status.busyFlag",&busyFlag);
-			printf("DoneFlag: %d\n",doneFlag);
-			printf("BusyFlag: %d\n",busyFlag);
-			fflush(stdout);
-			if(doneFlag==1){
-				return 1;
-			}
-			checkFlag_timer=0;
-		}
-		print_ctr++;
-		checkFlag_timer++;
+	if(aborted){
+		writeToBoardFloat(connection,"vel_targ_2",0);
+		writeToBoard(connection,"state_2.run",0);
+		writeToBoard(connection, "sysid_control.resetBit", 1);
+		writeToBoard(connection, "sysid_control.resetBit", 1);
 	}
+	return aborted;
 }
 
 
-int sysIdentification(SOCKET socket,int values, char *mode, char*fileName){
+int sysIdentification(BoardConnection *connection,int values, char *mode, char*fileName){
 	/*if(strcmp(mode,"Current")!= 0 || strcmp(mode,"Velocity")!= 0 || strcmp(mode,"Position")!= 0 ){
 		fprintf(stderr,"Wrong input type. Only Current, Velocity, Position");
 		return 1;
 	}*/
-	writeToBoard(socket, "sysid_control.resetBit", 1);
+	writeToBoard(connection, "sysid_control.resetBit", 1);
 	sleep(1);
 	float min_freq = 10;
 	float max_freq = 3000;
 	float excitation_amp = 0;//0.25;//1;
-	uint32_t index = 1;
 	uint32_t length = 256;// 511 = max. length
-	uint32_t busyFlag;
+	uint32_t busyFlag = 0;
 	float vel_factor = 0.002777;
 	float vel_in_degree_per_second = 2;
 	float vel = vel_in_degree_per_second * vel_factor;
 	double pos_start = 350;
 	double pos_end = 20;
-	writeToBoard(socket, "sysid_length", length);
-	writeToBoardFloat(socket, "sysid_min_fre", min_freq);
-	writeToBoardFloat(socket, "sysid_max_fre", max_freq);
-	writeToBoardFloat(socket, "sysid_excitat", excitation_amp);
+	writeToBoard(connection, "sysid_length", length);
+	writeToBoardFloat(connection, "sysid_min_fre", min_freq);
+	writeToBoardFloat(connection, "sysid_max_fre", max_freq);
+	writeToBoardFloat(connection, "sysid_excitat", excitation_amp);
 
-	startMotor(&socket);
+	startMotor(connection);
 
 //	char *items[] = {"current", "startBit"};
 //	int val[] = {1, 1};
 	uint32_t data = 5;//3;//5;//9;
 	if(data == (uint32_t)5){
-		writeToBoardFloat(socket,"vel_targ_2", vel);
+		writeToBoardFloat(connection,"vel_targ_2", vel);
 	}
 	char datac [2];
 	uint32ToCharArray(data, datac, 2);
-	VLItem item;
-	getVLItem(&item, "sysid_control");
-	writeRamF(socket, datac, 2, &item);
-	//writeToBoardBitItems(socket, "sysid_control", items, val, 2);
+	VLItem *item;
+	if(getVLItem(connection, &item, "sysid_control")==0){
+		writeRamF(connection, datac, 2, item);
+	}
+	//writeToBoardBitItems(connection, "sysid_control", items, val, 2);
 	fflush(stderr);
 	printf("Startup\n");
 	fflush(stdout);
 	//MAYBE WAIT FOR RECIEVE
-	float amplitude;
-	float phase;
-	float frequency;
-	//
-	uint32_t doneFlag;
+	uint32_t doneFlag = 0;
 	if(data == ((uint32_t)5)){
-		if(toggleTrajectorySYSID(&socket, vel, pos_start, pos_end, busyFlag, doneFlag) == 0){
+		if(toggleTrajectorySYSID(connection, vel, pos_start, pos_end, busyFlag, doneFlag) == 0){
 			return -1;
 		}
 	}
-	else{
-		while(1){
-			readFromBoardBitItem(socket,"sysid_status.doneFlag",&doneFlag);
-			readFromBoardBitItem(socket,"sysid_status.busyFlag",&busyFlag);
-			printf("DoneFlag: %d\n",doneFlag);
-			printf("BusyFlag: %d\n\n",busyFlag);
-			fflush(stdout);
-			sleep(1);
-			if(doneFlag==1)break;
-
-			if (kbhit()){
-				writeToBoardFloat(socket,"vel_targ_2",0);
-				writeToBoard(socket,"state_2.run",0);
-				writeToBoard(socket, "sysid_control.resetBit", 1);
-				writeToBoard(socket, "sysid_control.resetBit", 1);
-				return 0;
-			}
-		}
+	else if(waitForSweep(connection) == 1){
+		return 0;
 	}
 
 	printf("Messung abgeschlossen\n");
 	fflush(stdout);
+	// all points are read into memory first, the file is written after the readout
+	SysidPoint points[SYSID_MAX_POINTS];
+	SysidReadoutStats readout;
+	int readoutError = readSysidResults(connection, points, length, &readout);
+	printSysidReadoutStats(&readout, stdout);
+	fflush(stdout);
 	FILE *fd = fopen(fileName, "w");
 	if (fd == NULL) {
 		return 1;
 	}
-	while(index <= length){
-		writeToBoard(socket,"sysid_index",index);
-		while(1){
-			uint32_t indexToRead;
-			readFromBoardBitItem(socket, "sysid_status.indexToRead", &indexToRead);
-			if(indexToRead == index)break;
-			usleep(40000);
-		}
-
-		readFromBoardFloat(socket, "sysid_amp",&(amplitude));
-		readFromBoardFloat(socket, "sysid_phase",&(phase));
-		readFromBoardFloat(socket, "sysid_freq",&(frequency));
-		printf("Index %d read\n",index);
-		fflush(stdout);
-		fprintf(fd, "%f %f %f\n", log10(amplitude), phase*(180/3.1415), frequency);
-		index+=1;
+	for(uint32_t i = 0; i < readout.points; i++){
+		fprintf(fd, "%f %f %f\n", log10(points[i].amplitude), points[i].phase*(180/3.1415), points[i].frequency);
 	}
-	writeToBoard(socket, "sysid_control.resetBit", 1);
-	writeToBoard(socket, "sysid_control.resetBit", 1);
+	if(readoutError == 1){
+		fprintf(stderr,"Sysid readout stopped after %u of %u points\n", readout.points, length);
+	}
+	writeToBoard(connection, "sysid_control.resetBit", 1);
+	writeToBoard(connection, "sysid_control.resetBit", 1);
 	fclose(fd);
 	visualiseGraph(fileName);
 	return 0;
 }
 
-int startMotorSelf(SOCKET *clientSocket){
-
+// State of the self driven motor loop, the axle is moved back and forth until a key is pressed
+typedef struct
+{
+	BoardConnection *connection;
+	ItemHandle *run2;
+	ItemHandle *velTarg2;
+	ItemHandle *pos2Item;
+	float velval;
+	double pos_start;
+	double pos_end;
+	double limit_start;
+	double limit_end;
 	int32_t pos2;
-	float velval = 0.00277*2;
+	int print_ctr;
+	int send_ctr_end;
+	int send_ctr_start;
+} MotorTrajectory;
+
+static int motorTrajectoryCycle(void *userData){
+	MotorTrajectory *loop = userData;
 	int32_t calcValue;
 	double angle;
 	double incToDec;
-	int print_ctr = 0;
-	int send_ctr_end = 0;
-	int send_ctr_start = 0;
-
-	// --- pos/limit values in degrees | change value for toggle path here ---
-	double pos_start = 350;
-	double pos_end = 80;
-	double limit_start = 270;
-	double limit_end = 260;
-	// -----------------------------------------------------------------------
-
-	writeToBoard(*clientSocket,"state_2.motionmode",0);
-	writeToBoard(*clientSocket,"state_1.motionmode",0);
-	writeToBoard(*clientSocket,"state_1.run",0);
-	writeToBoard(*clientSocket,"state_2.run",0);
-	printf("Start\n");
-//	clearBoardBitItems(*clientSocket, "errorAction_1");
-//	clearBoardBitItems(*clientSocket, "errorAction_2");
-//	sleep_us(800000);
-	writeToBoard(*clientSocket,"peripherial.aux",1);
-	writeToBoard(*clientSocket,"state_2.motionmode",2);
-	writeToBoard(*clientSocket,"state_1.motionmode",2);
-	writeToBoard(*clientSocket,"state_2.motionmode",2);
-	writeToBoard(*clientSocket,"state_1.motionmode",2);
-	//sleep_us(200000);
-	writeToBoard(*clientSocket,"state_2.run",1);
-	writeToBoard(*clientSocket,"state_2.run",1);
-	//sleep_us(100000);
-	writeToBoardFloat(*clientSocket,"vel_targ_2", velval);
 	uint32_t num;
+	uint32_t rawPos;
 
+	if (kbhit()){
+		writeItemFloat(loop->connection,loop->velTarg2,0);
+		writeItem(loop->connection,loop->run2,0);
+		return 1;
+	}
 
-	while(1){
+	if(readItem(loop->connection, loop->pos2Item, &rawPos) == 0){
+		loop->pos2 = (int32_t) rawPos;
+	}
+	calcValue = loop->pos2 & 0x3FFFFFFF;
+	incToDec = 360.0 / pow(2, 30);
+	angle = (double)calcValue * incToDec;
+
+	if(loop->print_ctr > 30){
+		readItem(loop->connection,loop->run2, &num);
+		printf("RUNBIT IS :%d\n",num);
+		printf("%.1f\n",angle);
+		fflush(stdout);
+		loop->print_ctr = 0;
+	}
 
-		if (kbhit()){
-			writeToBoardFloat(*clientSocket,"vel_targ_2",0);
-			writeToBoard(*clientSocket,"state_2.run",0);
-			break;
+	if(angle >= loop->pos_end && angle <= loop->limit_end){
+		if(loop->send_ctr_start < 6){
+			printf("Send negative vel_targ\n");
+			loop->velval = -0.00277*2;
+			writeItemFloat(loop->connection,loop->velTarg2,loop->velval);
+			loop->send_ctr_start++;
+			loop->send_ctr_end=0;
 		}
-
-		readFromBoardInt32(*clientSocket, "pos_2", &pos2);
-		sleep_us(10000);
-		calcValue = pos2 & 0x3FFFFFFF;
-		incToDec = 360.0 / pow(2, 30);
-		angle = (double)calcValue * incToDec;
-
-		if(print_ctr > 30){
-			readFromBoardBitItem(*clientSocket,"state_2.run", &num);
-			printf("RUNBIT IS :%d\n",num);
-			printf("%.1f\n",angle);
-			fflush(stdout);
-			print_ctr = 0;
+	}
+	if(angle <= loop->pos_start && angle >= loop->limit_start){
+		if(loop->send_ctr_end < 6){
+			printf("Send positive vel_targ\n");
+			loop->velval = 0.00277*2;
+			writeItemFloat(loop->connection,loop->velTarg2,loop->velval);
+			loop->send_ctr_end++;
+			loop->send_ctr_start=0;
 		}
+	}
+	loop->print_ctr++;
+	return 0;
+}
 
-		if(angle >= pos_end && angle <= limit_end){
-			if(send_ctr_start < 6){
-				printf("Send negative vel_targ\n");
-				velval = -0.00277*2;
-				writeToBoardFloat(*clientSocket,"vel_targ_2",velval);
-				send_ctr_start++;
-				send_ctr_end=0;
-			}
-		}
-		if(angle <= pos_start && angle >= limit_start){
-			if(send_ctr_end < 6){
-				printf("Send positive vel_targ\n");
-				velval = 0.00277*2;
-				writeToBoardFloat(*clientSocket,"vel_targ_2",velval);
-				send_ctr_end++;
-				send_ctr_start=0;
-			}
-		}
-		print_ctr++;
+int startMotorSelf(BoardConnection *connection){
+	MotorTrajectory loop = {
+		.connection = connection,
+		.velval = 0.00277*2
+	};
+	PeriodicExecutor executor;
+
+	// --- pos/limit values in degrees | change value for toggle path here ---
+	loop.pos_start = 350;
+	loop.pos_end = 80;
+	loop.limit_start = 270;
+	loop.limit_end = 260;
+	// -----------------------------------------------------------------------
 
-		//sleep_us(10000);
+	// items of the loop are resolved once, the loop itself does no name lookups
+	ItemHandle *motionMode1 = NULL, *motionMode2 = NULL, *run1 = NULL, *aux = NULL;
+	if(resolveItem(connection, "state_1.motionmode", &motionMode1) == 1
+			|| resolveItem(connection, "state_2.motionmode", &motionMode2) == 1
+			|| resolveItem(connection, "state_1.run", &run1) == 1 || resolveItem(connection, "state_2.run", &loop.run2) == 1
+			|| resolveItem(connection, "peripherial.aux", &aux) == 1
+			|| resolveItem(connection, "vel_targ_2", &loop.velTarg2) == 1
+			|| resolveItem(connection, "pos_2", &loop.pos2Item) == 1){
+		fprintf(stderr,"Resolving the motor items failed\n");
+		releaseItem(motionMode1);
+		releaseItem(motionMode2);
+		releaseItem(run1);
+		releaseItem(loop.run2);
+		releaseItem(aux);
+		releaseItem(loop.velTarg2);
+		releaseItem(loop.pos2Item);
+		return 1;
 	}
+
+	writeItem(connection,motionMode2,0);
+	writeItem(connection,motionMode1,0);
+	writeItem(connection,run1,0);
+	writeItem(connection,loop.run2,0);
+	printf("Start\n");
+//	clearBoardBitItems(connection, "errorAction_1");
+//	clearBoardBitItems(connection, "errorAction_2");
+//	sleep_us(800000);
+	writeItem(connection,aux,1);
+	writeItem(connection,motionMode2,2);
+	writeItem(connection,motionMode1,2);
+	writeItem(connection,motionMode2,2);
+	writeItem(connection,motionMode1,2);
+	//sleep_us(200000);
+	writeItem(connection,loop.run2,1);
+	writeItem(connection,loop.run2,1);
+	//sleep_us(100000);
+	writeItemFloat(connection,loop.velTarg2, loop.velval);
+
+	initPeriodicExecutor(&executor, "motor trajectory", MOTION_LOOP_PERIOD_NS, motorTrajectoryCycle, &loop);
+	runPeriodicExecutor(&executor);
+	dumpPeriodicStats(&executor, stdout);
+
+	releaseItem(motionMode1);
+	releaseItem(motionMode2);
+	releaseItem(run1);
+	releaseItem(loop.run2);
+	releaseItem(aux);
+	releaseItem(loop.velTarg2);
+	releaseItem(loop.pos2Item);
 	return 0;
 }
 
 
-int initBoard(SOCKET *clientSocket){
-	writeToBoardFloat(*clientSocket, "cur_lim", 7);
-	writeToBoardFloat(*clientSocket, "curpeak_lim", 12);
-	writeToBoardFloat(*clientSocket, "curpeak_time", 2);
-	writeToBoardFloat(*clientSocket, "curphase_lim", 13);
-	writeToBoardFloat(*clientSocket, "temp_err", 80);
-
-	clearBoardBitItems(*clientSocket, "state_1");
-	writeToBoard(*clientSocket, "polnr_1", 11);
-	writeToBoard(*clientSocket, "enc_1" , 15744); //WHATS THIS ?
-	writeToBoard(*clientSocket, "angleconfig_1.el_dir", 1);
-	writeToBoard(*clientSocket, "state_1.angleconfig", 1);
-	writeToBoardFloat(*clientSocket, "kp_cur_1", 0.4);
-	writeToBoardFloat(*clientSocket, "ki_cur_1", 15);
-	writeToBoardFloat(*clientSocket, "kp_vel_1", 900);
-	writeToBoardFloat(*clientSocket, "kp_pos_1", 20);
-	writeToBoardFloat(*clientSocket, "ki_vel_1", 50000);
-	writeToBoardFloat(*clientSocket, "Dz_filt_1", 0 );
-	writeToBoardFloat(*clientSocket, "Wz_filt_1", 3553058);
-	writeToBoardFloat(*clientSocket, "Tz_filt_1", 0);
-	writeToBoardFloat(*clientSocket, "Dp_filt_1", 7540);
-	writeToBoardFloat(*clientSocket, "Wp_filt_1", 3553058);
-	writeToBoardFloat(*clientSocket, "Tp_filt_1", 1);
-	writeToBoardFloat(*clientSocket, "K_filt_1", 1);
-	writeToBoardFloat(*clientSocket, "f_velmeas_1", 1500);
-	writeToBoard(*clientSocket, "state_1.motionmode", 2);
-	writeToBoard(*clientSocket, "errorAction_1.all", 1);
-
-	clearBoardBitItems(*clientSocket, "state_2");
-	writeToBoard(*clientSocket, "polnr_2", 11);
-	writeToBoard(*clientSocket, "enc_2", 15744); //WHATS THIS ?
-	writeToBoard(*clientSocket, "angleconfig_2.el_dir", 1);
-	writeToBoard(*clientSocket, "state_2.angleconfig", 1);
-	writeToBoardFloat(*clientSocket, "kp_cur_2", 0.4);
-	writeToBoardFloat(*clientSocket, "ki_cur_2", 15);
-	writeToBoardFloat(*clientSocket, "kp_vel_2", 900);
-	writeToBoardFloat(*clientSocket, "kp_pos_2", 20);
-	writeToBoardFloat(*clientSocket, "ki_vel_2", 50000);
-	writeToBoardFloat(*clientSocket, "Dz_filt_2", 0);
-	writeToBoardFloat(*clientSocket, "Wz_filt_2", 1);
-	writeToBoardFloat(*clientSocket, "Tz_filt_2", 0);
-	writeToBoardFloat(*clientSocket, "Dp_filt_2", 0);
-	writeToBoardFloat(*clientSocket, "Wp_filt_2", 1);
-	writeToBoardFloat(*clientSocket, "Tp_filt_2", 0);
-	writeToBoardFloat(*clientSocket, "K_filt_2", 1);
-	writeToBoardFloat(*clientSocket, "f_velmeas_2", 1500);
-	writeToBoard(*clientSocket, "state_2.motionmode", 2);
-	writeToBoard(*clientSocket, "errorAction_2.all", 1);
-
-	writeToBoard(*clientSocket, "pos_err_1", 179132);
-	writeToBoardFloat(*clientSocket, "cur_err_1", 13);
-
-	writeToBoardFloat(*clientSocket, "pos_min_1", -2);
-	writeToBoardFloat(*clientSocket, "pos_max_1", 2);
+int initBoard(BoardConnection *connection){
+	// all parameters are queued and sent in pipelined bursts, bit items of the same word are written as one
+	BoardWriteBatch batch;
+	int error = 0;
+	writeBatchInit(&batch, connection);
+
+	// the axes are stopped before they are configured, the coalesced state words are only sent after the parameters
+	writeBatchClearBitItems(&batch, "state_1");
+	writeBatchClearBitItems(&batch, "state_2");
+	error |= writeBatchFlush(&batch);
+
+	writeBatchAddFloat(&batch, "cur_lim", 7);
+	writeBatchAddFloat(&batch, "curpeak_lim", 12);
+	writeBatchAddFloat(&batch, "curpeak_time", 2);
+	writeBatchAddFloat(&batch, "curphase_lim", 13);
+	writeBatchAddFloat(&batch, "temp_err", 80);
+
+	writeBatchAdd(&batch, "polnr_1", 11);
+	writeBatchAdd(&batch, "enc_1" , 15744); //WHATS THIS ?
+	writeBatchAdd(&batch, "angleconfig_1.el_dir", 1);
+	writeBatchAdd(&batch, "state_1.angleconfig", 1);
+	writeBatchAddFloat(&batch, "kp_cur_1", 0.4);
+	writeBatchAddFloat(&batch, "ki_cur_1", 15);
+	writeBatchAddFloat(&batch, "kp_vel_1", 900);
+	writeBatchAddFloat(&batch, "kp_pos_1", 20);
+	writeBatchAddFloat(&batch, "ki_vel_1", 50000);
+	writeBatchAddFloat(&batch, "Dz_filt_1", 0 );
+	writeBatchAddFloat(&batch, "Wz_filt_1", 3553058);
+	writeBatchAddFloat(&batch, "Tz_filt_1", 0);
+	writeBatchAddFloat(&batch, "Dp_filt_1", 7540);
+	writeBatchAddFloat(&batch, "Wp_filt_1", 3553058);
+	writeBatchAddFloat(&batch, "Tp_filt_1", 1);
+	writeBatchAddFloat(&batch, "K_filt_1", 1);
+	writeBatchAddFloat(&batch, "f_velmeas_1", 1500);
+	writeBatchAdd(&batch, "state_1.motionmode", 2);
+	writeBatchAdd(&batch, "errorAction_1.all", 1);
+
+	writeBatchAdd(&batch, "polnr_2", 11);
+	writeBatchAdd(&batch, "enc_2", 15744); //WHATS THIS ?
+	writeBatchAdd(&batch, "angleconfig_2.el_dir", 1);
+	writeBatchAdd(&batch, "state_2.angleconfig", 1);
+	writeBatchAddFloat(&batch, "kp_cur_2", 0.4);
+	writeBatchAddFloat(&batch, "ki_cur_2", 15);
+	writeBatchAddFloat(&batch, "kp_vel_2", 900);
+	writeBatchAddFloat(&batch, "kp_pos_2", 20);
+	writeBatchAddFloat(&batch, "ki_vel_2", 50000);
+	writeBatchAddFloat(&batch, "Dz_filt_2", 0);
+	writeBatchAddFloat(&batch, "Wz_filt_2", 1);
+	writeBatchAddFloat(&batch, "Tz_filt_2", 0);
+	writeBatchAddFloat(&batch, "Dp_filt_2", 0);
+	writeBatchAddFloat(&batch, "Wp_filt_2", 1);
+	writeBatchAddFloat(&batch, "Tp_filt_2", 0);
+	writeBatchAddFloat(&batch, "K_filt_2", 1);
+	writeBatchAddFloat(&batch, "f_velmeas_2", 1500);
+	writeBatchAdd(&batch, "state_2.motionmode", 2);
+	writeBatchAdd(&batch, "errorAction_2.all", 1);
+
+	writeBatchAdd(&batch, "pos_err_1", 179132);
+	writeBatchAddFloat(&batch, "cur_err_1", 13);
+
+	writeBatchAddFloat(&batch, "pos_min_1", -2);
+	writeBatchAddFloat(&batch, "pos_max_1", 2);
 	//written as one
-	writeToBoard(*clientSocket,"errorAction_1.pos", 1); // Why?q
-	writeToBoard(*clientSocket,"errorAction_1.ichouse", 1); // Why?
+	writeBatchAdd(&batch, "errorAction_1.pos", 1); // Why?q
+	writeBatchAdd(&batch, "errorAction_1.ichouse", 1); // Why?
 
-	writeToBoard(*clientSocket, "pos_err_2", 179132);
-	writeToBoardFloat(*clientSocket, "cur_err_2", 13);
+	writeBatchAdd(&batch, "pos_err_2", 179132);
+	writeBatchAddFloat(&batch, "cur_err_2", 13);
 
-	writeToBoardFloat(*clientSocket, "pos_min_2", -2);
-	writeToBoardFloat(*clientSocket, "pos_max_2", 2);
+	writeBatchAddFloat(&batch, "pos_min_2", -2);
+	writeBatchAddFloat(&batch, "pos_max_2", 2);
 	//written as one
-	writeToBoard(*clientSocket,"errorAction_2.pos", 1);	// Why?
-	writeToBoard(*clientSocket,"errorAction_2.ichouse", 1); // Why?
-
-	writeToBoard(*clientSocket,"epsilon0PU_2", 364);
-	writeToBoard(*clientSocket,"epsilon0PU_1", 43872);
-
-	writeToBoard(*clientSocket,"peripherial.aux" , 1);
-	writeToBoardFloat(*clientSocket, "acc_lim_1", 0.013888);
-	writeToBoardFloat(*clientSocket, "vel_lim_1", 0.027777);
-	writeToBoardFloat(*clientSocket, "vel_targ_1", 0);
-	writeToBoardFloat(*clientSocket, "acc_lim_2", 0.013888);
-	writeToBoardFloat(*clientSocket, "vel_lim_2", 0.027777);
-	writeToBoardFloat(*clientSocket, "vel_targ_2", 0);
-
-	clearBoardBitItems(*clientSocket, "errorAction_1");
-	clearBoardBitItems(*clientSocket, "errorAction_2");
+	writeBatchAdd(&batch, "errorAction_2.pos", 1);	// Why?
+	writeBatchAdd(&batch, "errorAction_2.ichouse", 1); // Why?
+
+	writeBatchAdd(&batch, "epsilon0PU_2", 364);
+	writeBatchAdd(&batch, "epsilon0PU_1", 43872);
+
+	writeBatchAdd(&batch, "peripherial.aux" , 1);
+	writeBatchAddFloat(&batch, "acc_lim_1", 0.013888);
+	writeBatchAddFloat(&batch, "vel_lim_1", 0.027777);
+	writeBatchAddFloat(&batch, "vel_targ_1", 0);
+	writeBatchAddFloat(&batch, "acc_lim_2", 0.013888);
+	writeBatchAddFloat(&batch, "vel_lim_2", 0.027777);
+	writeBatchAddFloat(&batch, "vel_targ_2", 0);
+
+	error |= writeBatchFlush(&batch);
+
+	// the error actions are cleared after being set, so they must not be coalesced with the writes above
+	writeBatchClearBitItems(&batch, "errorAction_1");
+	writeBatchClearBitItems(&batch, "errorAction_2");
+	error |= writeBatchFlush(&batch);
 	sleep_us(1000000);
 
-	//startMotorSelf(clientSocket);
-	return 0;
+	//startMotorSelf(connection);
+	return error;
 }
 
 
 
-int initialise(SOCKET *clientSocket){
+/**
+ * Reads all items from the board, combines them with the configuration into vlItem.json and creates the catalog
+ * the VLItems are loaded from.
+ *
+ * @param connection Connection to the control board.
+ * @param boardItemCount Number of items on the board.
+ * @param fingerprint Fingerprint of the board and configuration, stored in the catalog.
+ * @param boardItems Items described by getBoardFingerprint, only their default values are read.
+ * @return 0 on success, 1 on failure.
+ */
+int discoverBoardItems(BoardConnection *connection, int boardItemCount, BoardFingerprint *fingerprint, BoardItem *boardItems){
+	int error = 0;
+	VLItem *vlItems = calloc(boardItemCount, sizeof(VLItem));
+	if(vlItems == NULL){
+		fprintf(stderr,"ERROR: Memory allocation for the board items failed\n");
+		return 1;
+	}
+
+	if(getBoardItemDefaults(connection, boardItems, boardItemCount)==1){
+		fprintf(stderr,"ERROR: Reading the board items failed\n");
+		error = 1;
+	}else if(createDataJson(boardItems, boardItemCount, vlItems)==1){
+		fprintf(stderr,"ERROR: vlItem.json creation failed\n");
+		error = 1;
+	}else if(createBoardCatalog(connection, fingerprint, vlItems, boardItemCount)==1){
+		fprintf(stderr,"ERROR: VLItem catalog creation failed\n");
+		error = 1;
+	}
+
+	for(int i = 0; i < boardItemCount; i++){
+		free(vlItems[i].BitItems);
+	}
+	free(vlItems);
+	return error;
+}
+
+/**
+ * Connects to the board of the axle, loads the VLItems and configures the board. Runs in the thread of the axle,
+ * the connection is only used by that thread.
+ *
+ * @param connection Initialised connection of the axle, closed again if the initialisation fails
+ * @return 0 on success, 1 otherwise
+ */
+int initialise(BoardConnection *connection){
 	//visualiseGraph("sysidplot.txt");
 	initLogger("log.txt");
 
 	int boardItemCount = 0;
 
 	iniToJson();
-	if(createConnection((SOCKET *)clientSocket,axleIPAdress,axlePort)==1)exit(EXIT_FAILURE);
+#ifdef BOARD_TRACE
+	// opened before the first transaction, the status and fingerprint requests are traced as well
+	if(openBoardTrace(&connection->trace, BOARD_TRACE_FILE, BOARD_TRACE_RECORDS)==1){
+		fprintf(stderr,"WARNING: Board trace couldn't be opened, transactions are logged as text\n");
+	}
+#endif
+	if(createConnection(connection,axleIPAdress,axlePort)==1){
+		closeBoardTrace(&connection->trace);
+		return 1;
+	}
 
 	int status = -1;
-	if(getSocketStatus(*clientSocket,&status)==1)exit(EXIT_FAILURE);
-	if(status != 0){
-		error_handler("Board is not ready\n");
+	if(getSocketStatus(connection,&status)==1 || status != 0){
+		fprintf(stderr,"ERROR: Board of axle %d is not ready\n",axleNum);
+		closeBoardConnection(connection);
+		return 1;
 	}
 
-	if(getBoardItemCount(*clientSocket,&boardItemCount)==1){
+	if(getBoardItemCount(connection,&boardItemCount)==1){
 		fprintf(stderr,"ERROR: Important data transmission failed\n");
-		exit(EXIT_FAILURE);
+		closeBoardConnection(connection);
+		return 1;
 	}
-	if(getBoardItems(*clientSocket, boardItemCount)==1){
-		fprintf(stderr,"ERROR: boardItems.json creation failed\n");
-		exit(EXIT_FAILURE);
+	BoardFingerprint fingerprint;
+	BoardItem *boardItems = calloc(boardItemCount, sizeof(BoardItem));
+	if(boardItems == NULL){
+		fprintf(stderr,"ERROR: Memory allocation for the board items failed\n");
+		closeBoardConnection(connection);
+		return 1;
 	}
-	if(createDataJson(boardItemCount)==1){
-		fprintf(stderr,"ERROR: vlItem.json creation failed\n");
-		exit(EXIT_FAILURE);
+	if(getBoardFingerprint(connection, boardItemCount, &fingerprint, boardItems)==1){
+		fprintf(stderr,"ERROR: Important data transmission failed\n");
+		free(boardItems);
+		closeBoardConnection(connection);
+		return 1;
 	}
-	initBoard(clientSocket);
+	// the board items are only discovered again if the item table or the configuration changed, the describe
+	// replies of the fingerprint are reused for it
+	int error = openBoardCatalog(connection, &fingerprint)==1
+			&& discoverBoardItems(connection, boardItemCount, &fingerprint, boardItems)==1;
+	free(boardItems);
+	if(error){
+		closeBoardConnection(connection);
+		return 1;
+	}
+	// the board changes these words itself: it clears the reset and start bits of the sysid and the run and error
+	// bits of the axes on a fault, a merged shadow word could set them again
+	char *boardOwnedItems[] = { "sysid_control", "state_1", "state_2", "errorAction_1", "errorAction_2" };
+	for(size_t i = 0; i < sizeof(boardOwnedItems) / sizeof(boardOwnedItems[0]); i++){
+		bypassBoardShadow(connection, boardOwnedItems[i]);
+	}
+	initBoard(connection);
 	return 0;
 }
 
 
 
-void readOutAngle(SOCKET *clientSocket){
-// Implemented for Test Purposes
+// State of the angle readout loop
+typedef struct
+{
+	BoardConnection *connection;
+	ItemHandle *pos2Item;
 	int32_t pos2;
+	int print_ctr;
+} AngleReadout;
+
+static int angleReadoutCycle(void *userData){
+	AngleReadout *loop = userData;
 	int32_t calcValue;
 	double angle;
 	double incToDec;
-	int print_ctr = 0;
-
-	while(1){
-		readFromBoardInt32(*clientSocket, "pos_2", &pos2);
-		sleep_us(10000);
-		calcValue = pos2 & 0x3FFFFFFF;
-		incToDec = 360.0 / pow(2, 30);
-		angle = (double)calcValue * incToDec;
-
-		if(print_ctr > 30){
-			printf("%.1f\n",angle);
-			print_ctr = 0;
-		}
-		print_ctr++;
+	uint32_t rawPos;
+
+	if (kbhit()){
+		return 1;
 	}
+	if(readItem(loop->connection, loop->pos2Item, &rawPos) == 0){
+		loop->pos2 = (int32_t) rawPos;
+	}
+	calcValue = loop->pos2 & 0x3FFFFFFF;
+	incToDec = 360.0 / pow(2, 30);
+	angle = (double)calcValue * incToDec;
+
+	if(loop->print_ctr > 30){
+		printf("%.1f\n",angle);
+		loop->print_ctr = 0;
+	}
+	loop->print_ctr++;
+	return 0;
 }
 
-unsigned int axleController(){
-	
-	/*AxleArguments* axArg = (AxleArguments*)arg;
+void readOutAngle(BoardConnection *connection){
+// Implemented for Test Purposes
+	AngleReadout loop = { .connection = connection };
+	PeriodicExecutor executor;
 
-	axleNum = axArg->axleNum;
-	memcpy(axleIPAdress,axArg->ip_address,16);
-	axlePort = axArg->port;
+	if(resolveItem(connection, "pos_2", &loop.pos2Item) == 1){
+		return;
+	}
+	initPeriodicExecutor(&executor, "angle readout", MOTION_LOOP_PERIOD_NS, angleReadoutCycle, &loop);
+	runPeriodicExecutor(&executor);
+	dumpPeriodicStats(&executor, stdout);
+	releaseItem(loop.pos2Item);
+}
 
-	printf("AXLENUM: %d, IP-Adress: %s, Port. %d\n",axArg->axleNum, axArg->ip_address, axArg->port);
-	fflush(stdout);*/
+// Entry of the axle threads, axleNum, axleIPAdress and axlePort are set by startAxleThread
+unsigned int axleController(){
+	// owned by the stack of the axle thread, a thread local would be allocated in every thread of the process
+	BoardConnection connection;
+	initBoardConnection(&connection);
+
+	printf("AXLENUM: %d, IP-Adress: %s, Port. %d\n",axleNum, axleIPAdress, axlePort);
+	fflush(stdout);
 
-	sysIdentification(clientSocket,128,"","test.txt");
-	closesocket(clientSocket);
-	WSACleanup();
+	sysIdentification(&connection,128,"","test.txt");
+	dumpCommStats(&connection.stats, stdout);
+	closeBoardConnection(&connection);
+	socketsShutdown();
 	printf("Close Socket\n");
 	fflush(stdout);
 	closeLogger();
@@ -0,0 +1,269 @@
+/**
+ * @file bit_watcher.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Blocking waits for changes of board status bits
+ *
+ * @details Waiting for a status bit like sysid_status.doneFlag used to poll it with long sleeps in between, so a
+ *	change was noticed up to a second late. A bit watcher polls its items with a process image at a high rate and
+ *	compares every refresh with the previous one. Changes are counted as rising or falling edges and wake all
+ *	callers blocked in waitForValue or waitForEdge through a condition variable, so they return within one poll
+ *	period after the board changed the bit. Pulses shorter than the poll period can't be seen.
+ *	Like for every process image, threads writing to the connection while the watcher runs hold its lock.
+ **/
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "bit_watcher.h"
+#include "transport.h"
+
+#ifdef POSIX_BACKEND
+#define WATCH_CLOCK CLOCK_MONOTONIC
+#else
+#define WATCH_CLOCK CLOCK_REALTIME
+#endif
+
+#define WATCH_START_ATTEMPTS 2	// refreshes startBitWatcher gives the board to answer, each one may time out
+
+
+/**
+ * @brief Counts the changes of a refresh and wakes the waiting callers, called by the poller
+ * @param snapshot Refresh of the process image
+ * @param userData Bit watcher
+ */
+static void detectChanges(const ProcessImageSnapshot *snapshot, void *userData){
+	BitWatcher *watcher = userData;
+	int changed = 0;
+	int answered = 0;
+
+	pthread_mutex_lock(&watcher->lock);
+	for(size_t i = 0; i < watcher->image.count; i++){
+		WatchedItem *item = &watcher->items[i];
+		uint32_t value = snapshot->values[i];
+		answered |= snapshot->status[i] == 0;
+		if(snapshot->status[i] != 0 || (item->valid && value == item->value)){
+			continue;
+		}
+		if(item->valid){
+			if(value > item->value){
+				item->rising++;
+			}else{
+				item->falling++;
+			}
+		}
+		item->value = value;
+		item->valid = 1;
+		changed = 1;
+	}
+	// a refresh without any item read is no reference for startBitWatcher
+	if(answered){
+		watcher->refreshes++;
+	}
+	if(changed || (answered && watcher->refreshes == 1)){
+		pthread_cond_broadcast(&watcher->changed);
+	}
+	pthread_mutex_unlock(&watcher->lock);
+}
+
+
+/**
+ * @brief Calculates the absolute deadline of a wait on the clock of the condition variable
+ * @param timeout Timeout in ns
+ * @param deadline Pointer to store the deadline
+ */
+static void getDeadline(uint64_t timeout, struct timespec *deadline){
+	clock_gettime(WATCH_CLOCK, deadline);
+	uint64_t nanoseconds = deadline->tv_nsec + timeout % 1000000000ULL;
+	deadline->tv_sec += timeout / 1000000000ULL + nanoseconds / 1000000000ULL;
+	deadline->tv_nsec = nanoseconds % 1000000000ULL;
+}
+
+
+/**
+ * @brief Waits for the next change, the lock of the watcher is held by the caller
+ * @param watcher Bit watcher
+ * @param timeout Timeout in ns or BIT_WATCH_FOREVER
+ * @param deadline Deadline calculated by getDeadline
+ * @return 0 if woken, 1 after the timeout
+ */
+static int waitForChange(BitWatcher *watcher, uint64_t timeout, struct timespec *deadline){
+	if(timeout == BIT_WATCH_FOREVER){
+		pthread_cond_wait(&watcher->changed, &watcher->lock);
+		return 0;
+	}
+	return pthread_cond_timedwait(&watcher->changed, &watcher->lock, deadline) == ETIMEDOUT;
+}
+
+
+/**
+ * @brief Initialises a bit watcher without items
+ * @param watcher Bit watcher to initialise
+ * @param connection Connection the items are read from
+ * @param period Poll period in ns, e.g. BIT_WATCH_PERIOD_NS
+ * @return 0 on success, 1 otherwise
+ */
+int initBitWatcher(BitWatcher *watcher, BoardConnection *connection, uint64_t period){
+	pthread_condattr_t attributes;
+
+	memset(watcher->items, 0, sizeof(watcher->items));
+	watcher->stopped = 1;
+	initProcessImage(&watcher->image, connection, period);
+	setRefreshCallback(&watcher->image, detectChanges, watcher);
+	if(pthread_condattr_init(&attributes) != 0){
+		return 1;
+	}
+	pthread_condattr_setclock(&attributes, WATCH_CLOCK);
+	int error = pthread_mutex_init(&watcher->lock, NULL) != 0 || pthread_cond_init(&watcher->changed, &attributes) != 0;
+	pthread_condattr_destroy(&attributes);
+	return error;
+}
+
+
+/**
+ * @brief Adds an item or bit item in dot-notation, before the watcher is started
+ * @param watcher Bit watcher
+ * @param name Item name, optionally followed by '.' and a bit item name
+ * @param index Pointer to store the index to wait for the item with
+ * @return 0 on success, 1 if the item doesn't exist or the watcher is full or running
+ */
+int watchItem(BitWatcher *watcher, const char *name, int *index){
+	return subscribeItem(&watcher->image, name, index);
+}
+
+
+/**
+ * Starts polling the watched items and waits for the first refresh in which at least one item was read. The values
+ * read by it are the reference the edges are detected against, so every edge after the return is seen by
+ * waitForEdge. Refreshes the board didn't answer are not waited for, it gets WATCH_START_ATTEMPTS of them.
+ *
+ * @param watcher Bit watcher
+ * @return 0 on success, 1 if the poller couldn't be started or the board didn't answer
+ */
+int startBitWatcher(BitWatcher *watcher){
+	struct timespec deadline;
+	int timedOut = 0;
+	uint64_t timeout = WATCH_START_ATTEMPTS * (TRANSPORT_TIMEOUT_MS * 1000000ULL + watcher->image.executor.period);
+
+	pthread_mutex_lock(&watcher->lock);
+	memset(watcher->items, 0, sizeof(watcher->items));
+	watcher->refreshes = 0;
+	watcher->stopped = 0;
+	pthread_mutex_unlock(&watcher->lock);
+	if(startProcessImage(&watcher->image) == 1){
+		stopBitWatcher(watcher);
+		return 1;
+	}
+	getDeadline(timeout, &deadline);
+	pthread_mutex_lock(&watcher->lock);
+	while(watcher->refreshes == 0 && !timedOut){
+		timedOut = waitForChange(watcher, timeout, &deadline);
+	}
+	pthread_mutex_unlock(&watcher->lock);
+	if(timedOut){
+		stopBitWatcher(watcher);
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Stops polling, all waiting callers return 1
+ * @param watcher Bit watcher
+ */
+void stopBitWatcher(BitWatcher *watcher){
+	stopProcessImage(&watcher->image);
+	pthread_mutex_lock(&watcher->lock);
+	watcher->stopped = 1;
+	pthread_cond_broadcast(&watcher->changed);
+	pthread_mutex_unlock(&watcher->lock);
+}
+
+
+/**
+ * @brief Stops the watcher and releases the items and the condition variable
+ * @param watcher Bit watcher, no caller may wait anymore
+ */
+void releaseBitWatcher(BitWatcher *watcher){
+	stopBitWatcher(watcher);
+	releaseProcessImage(&watcher->image);
+	pthread_cond_destroy(&watcher->changed);
+	pthread_mutex_destroy(&watcher->lock);
+}
+
+
+/**
+ * @brief Gets the last value read of a watched item without waiting
+ * @param watcher Bit watcher
+ * @param index Index returned by watchItem
+ * @param value Pointer to store the value
+ * @return 0 on success, 1 if the item wasn't read yet
+ */
+int getWatchedValue(BitWatcher *watcher, int index, uint32_t *value){
+	pthread_mutex_lock(&watcher->lock);
+	int valid = watcher->items[index].valid;
+	*value = watcher->items[index].value;
+	pthread_mutex_unlock(&watcher->lock);
+	return !valid;
+}
+
+
+/**
+ * Blocks until a watched item has the given value. Returns at once if it already has it.
+ *
+ * @param watcher Running bit watcher
+ * @param index Index returned by watchItem
+ * @param value Value to wait for, e.g. 1 for a flag
+ * @param timeout Timeout in ns or BIT_WATCH_FOREVER
+ * @return 0 if the item has the value, 1 after the timeout or if the watcher was stopped
+ */
+int waitForValue(BitWatcher *watcher, int index, uint32_t value, uint64_t timeout){
+	WatchedItem *item = &watcher->items[index];
+	struct timespec deadline;
+	int timedOut = 0;
+
+	getDeadline(timeout, &deadline);
+	pthread_mutex_lock(&watcher->lock);
+	while(!(item->valid && item->value == value) && !watcher->stopped && !timedOut){
+		timedOut = waitForChange(watcher, timeout, &deadline);
+	}
+	int found = item->valid && item->value == value;
+	pthread_mutex_unlock(&watcher->lock);
+	return !found;
+}
+
+
+/**
+ * Blocks until the next edge of a watched item after the call. Edges of multi bit items are changes to a higher
+ * or lower value.
+ *
+ * @param watcher Running bit watcher
+ * @param index Index returned by watchItem
+ * @param edge Edge to wait for
+ * @param timeout Timeout in ns or BIT_WATCH_FOREVER
+ * @param value Pointer to store the value after the edge, may be NULL
+ * @return 0 if the edge was seen, 1 after the timeout or if the watcher was stopped
+ */
+int waitForEdge(BitWatcher *watcher, int index, WatchEdge edge, uint64_t timeout, uint32_t *value){
+	WatchedItem *item = &watcher->items[index];
+	struct timespec deadline;
+	int timedOut = 0;
+	int seen = 0;
+
+	getDeadline(timeout, &deadline);
+	pthread_mutex_lock(&watcher->lock);
+	uint64_t rising = item->rising;
+	uint64_t falling = item->falling;
+	while(!seen && !watcher->stopped && !timedOut){
+		timedOut = waitForChange(watcher, timeout, &deadline);
+		seen = (edge != WATCH_FALLING && item->rising != rising) || (edge != WATCH_RISING && item->falling != falling);
+	}
+	if(seen && value != NULL){
+		*value = item->value;
+	}
+	pthread_mutex_unlock(&watcher->lock);
+	return !seen;
+}
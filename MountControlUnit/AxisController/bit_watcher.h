@@ -0,0 +1,52 @@
+/*
+ * bit_watcher.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef BIT_WATCHER_H_
+#define BIT_WATCHER_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include "process_image.h"
+
+#define BIT_WATCH_PERIOD_NS 1000000ULL	// poll period of the status bits, waiting callers wake within 1 ms
+#define BIT_WATCH_FOREVER UINT64_MAX
+
+typedef enum
+{
+	WATCH_RISING,		// the value increased, 0 -> 1 for single bits
+	WATCH_FALLING,		// the value decreased, 1 -> 0 for single bits
+	WATCH_CHANGED
+} WatchEdge;
+
+typedef struct
+{
+	uint32_t value;		// last value read by the poller
+	uint64_t rising;	// edges counted since the watcher was started
+	uint64_t falling;
+	int valid;			// 0 until the item was read once
+} WatchedItem;
+
+typedef struct
+{
+	ProcessImage image;
+	WatchedItem items[PROCESS_IMAGE_ITEMS];		// indexed like the process image
+	pthread_mutex_t lock;
+	pthread_cond_t changed;		// signalled by the poller when a watched value changed or the watcher stopped
+	uint64_t refreshes;			// refreshes with at least one item read since the watcher was started
+	int stopped;
+} BitWatcher;
+
+int initBitWatcher(BitWatcher *watcher, BoardConnection *connection, uint64_t period);
+int watchItem(BitWatcher *watcher, const char *name, int *index);
+int startBitWatcher(BitWatcher *watcher);
+void stopBitWatcher(BitWatcher *watcher);
+void releaseBitWatcher(BitWatcher *watcher);
+int getWatchedValue(BitWatcher *watcher, int index, uint32_t *value);
+int waitForValue(BitWatcher *watcher, int index, uint32_t value, uint64_t timeout);
+int waitForEdge(BitWatcher *watcher, int index, WatchEdge edge, uint64_t timeout, uint32_t *value);
+
+#endif /* BIT_WATCHER_H_ */
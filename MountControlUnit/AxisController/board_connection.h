@@ -0,0 +1,44 @@
+/*
+ * board_connection.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef BOARD_CONNECTION_H_
+#define BOARD_CONNECTION_H_
+
+#include <pthread.h>
+#include "sockets.h"
+#include "comm_stats.h"
+#include "vlitem_catalog.h"
+#include "vlitem_handler.h"
+#include "shadow_register.h"
+#include "board_trace.h"
+
+#define DEFAULT_BUFLEN 128
+
+// Everything the communication with one board needs. Every function talking to a board gets the connection
+// passed, so any number of boards can be driven from any number of threads as long as one connection is only
+// used by one thread at a time. Threads sharing a connection, like a control loop and the poller of its process
+// image, hold the lock of the connection around every access to the board.
+typedef struct
+{
+	SOCKET socket;
+	unsigned char sendData[16];				// frame under construction
+	char receivedData[DEFAULT_BUFLEN];		// reply of the last transaction
+	char message[DEFAULT_BUFLEN*10];		// log line for logz
+	VlItemCatalog catalog;					// mapped vlItem.bin of the board
+	VlItemCache items;						// items of the catalog, indexed by name
+	ShadowRegisterFile shadows;				// item data last exchanged with the board, indexed like items
+	CommStats stats;
+	BoardTrace trace;						// binary trace of the transactions, see openBoardTrace
+	pthread_mutex_t lock;					// see lockBoardConnection
+} BoardConnection;
+
+void initBoardConnection(BoardConnection *connection);
+void closeBoardConnection(BoardConnection *connection);
+void lockBoardConnection(BoardConnection *connection);
+void unlockBoardConnection(BoardConnection *connection);
+
+#endif /* BOARD_CONNECTION_H_ */
@@ -0,0 +1,180 @@
+/**
+ * @file board_trace.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Binary trace of all board transactions
+ *
+ * @details Every frame exchanged with the board is appended as a fixed size BoardTraceRecord to a ring in
+ *	./axle_<n>/trace.bin. The file is mapped into memory, recording a transaction is a plain copy into the
+ *	mapping and never waits for the disk, the operating system writes the pages back on its own.
+ *	The trace is part of the board connection, it is written by whichever thread holds the connection, so no
+ *	locking is needed beyond the one of the connection. The file is converted to CSV with trace_decode.
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "board_trace.h"
+#include "common_utils.h"
+
+/**
+ * Opens the trace of the axle and maps it into memory. An existing trace with the same capacity is continued,
+ * otherwise the file is created again.
+ *
+ * @param trace Closed trace of the connection to the board of the axle
+ * @param fileName Name of the trace file in the directory of the axle
+ * @param capacity Number of records held by the ring
+ * @return 0 on success, 1 otherwise
+ */
+int openBoardTrace(BoardTrace *trace, char *fileName, uint32_t capacity){
+	char path[256];
+	void *base;
+	size_t size = sizeof(BoardTraceHeader) + (size_t)capacity * sizeof(BoardTraceRecord);
+
+	if(trace->header != NULL || capacity == 0){
+		return 1;
+	}
+	sprintf(path, "./axle_%d/%s",axleNum,fileName);
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS,
+			FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE){
+		return 1;
+	}
+	size_t oldSize = GetFileSize(file, NULL);
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, (DWORD)size, NULL);
+	CloseHandle(file);
+	if(mapping == NULL){
+		return 1;
+	}
+	base = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+	CloseHandle(mapping);
+	if(base == NULL){
+		return 1;
+	}
+#else
+	struct stat fileStat;
+	int file = open(path, O_RDWR | O_CREAT, 0644);
+	if(file == -1){
+		return 1;
+	}
+	if(fstat(file, &fileStat) == -1 || ftruncate(file, size) == -1){
+		close(file);
+		return 1;
+	}
+	size_t oldSize = fileStat.st_size;
+	base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	close(file);
+	if(base == MAP_FAILED){
+		return 1;
+	}
+#endif
+	BoardTraceHeader *header = base;
+	trace->header = header;
+	trace->records = (BoardTraceRecord*)((char*)base + sizeof(BoardTraceHeader));
+	trace->size = size;
+
+	if(oldSize != size || header->magic != BOARD_TRACE_MAGIC || header->version != BOARD_TRACE_VERSION
+			|| header->recordSize != sizeof(BoardTraceRecord) || header->capacity != capacity){
+		memset(base, 0, size);
+		header->magic = BOARD_TRACE_MAGIC;
+		header->version = BOARD_TRACE_VERSION;
+		header->recordSize = sizeof(BoardTraceRecord);
+		header->capacity = capacity;
+		header->head = 0;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Unmaps a trace, further transactions are not recorded anymore
+ * @param trace Trace to close, nothing happens if it isn't open
+ */
+void closeBoardTrace(BoardTrace *trace){
+	if(trace->header == NULL){
+		return;
+	}
+#ifdef _WIN32
+	FlushViewOfFile(trace->header, trace->size);
+	UnmapViewOfFile(trace->header);
+#else
+	msync(trace->header, trace->size, MS_ASYNC);
+	munmap(trace->header, trace->size);
+#endif
+	trace->header = NULL;
+	trace->records = NULL;
+	trace->size = 0;
+}
+
+
+/**
+ * @brief Checks if the transactions of a connection are traced
+ * @param trace Trace of the connection
+ * @return 1 if the trace is open, 0 otherwise
+ */
+int isBoardTraceOpen(BoardTrace *trace){
+	return trace->header != NULL;
+}
+
+
+/**
+ * Appends a transaction to the trace. The item and the payload are taken from the frame, for reads the payload
+ * is taken from the reply. Does nothing if the trace is not open.
+ *
+ * @param trace Trace of the connection the frame was sent on
+ * @param frame Encoded frame sent to the board
+ * @param reply Reply of the board, may be NULL if nothing was received
+ * @param start Monotonic time the frame was sent in ns
+ * @param end Monotonic time the reply was complete in ns
+ * @param retries Number of repeated transmissions
+ * @param status 0 on success, 1 on failure
+ */
+void traceBoardTransaction(BoardTrace *trace, const unsigned char *frame, const char *reply, uint64_t start,
+		uint64_t end, int retries, int status){
+	if(trace->header == NULL){
+		return;
+	}
+	BoardTraceRecord *record = &trace->records[trace->header->head % trace->header->capacity];
+	uint64_t rtt = end - start;
+
+	memset(record, 0, sizeof(BoardTraceRecord));
+	record->timestamp = start;
+	record->rtt = rtt > UINT32_MAX ? UINT32_MAX : (uint32_t)rtt;
+	record->function = frame[1];
+	record->retries = retries > UINT8_MAX ? UINT8_MAX : retries;
+	record->status = status;
+	switch(frame[1]){
+	case 2:
+		record->item = frame[4];
+		break;
+	case 3:
+		record->item = frame[2] | frame[3] << 8 | frame[4] << 16;
+		record->size = frame[0] > 8 ? 4 : frame[0] - 4;
+		memcpy(record->payload, &frame[5], record->size);
+		break;
+	case 4:
+		record->item = frame[2] | frame[3] << 8 | frame[4] << 16;
+		if(reply != NULL && status == 0){
+			record->size = frame[5] > 4 ? 4 : frame[5];
+			memcpy(record->payload, &reply[1], record->size);
+		}
+		break;
+	default:
+		if(reply != NULL && status == 0){
+			record->size = 2;
+			memcpy(record->payload, &reply[1], record->size);
+		}
+		break;
+	}
+	trace->header->head++;
+}
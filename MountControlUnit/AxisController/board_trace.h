@@ -0,0 +1,56 @@
+/*
+ * board_trace.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef BOARD_TRACE_H_
+#define BOARD_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BOARD_TRACE_FILE "trace.bin"
+#define BOARD_TRACE_MAGIC 0x43525442	// "BTRC"
+#define BOARD_TRACE_VERSION 1
+#define BOARD_TRACE_RECORDS 65536		// capacity of the ring, the oldest records are overwritten
+
+// One board transaction, written as it is to the trace file
+typedef struct
+{
+	uint64_t timestamp;		// monotonic time of the request in ns
+	uint32_t rtt;			// time from sending the frame until the reply was complete in ns
+	uint32_t item;			// RAM address of the item for reads and writes, item number for describe requests
+	uint8_t function;		// function code of the frame
+	uint8_t retries;
+	uint8_t status;			// 0 on success, 1 on failure
+	uint8_t size;			// number of valid payload bytes
+	uint8_t payload[4];		// raw value read from or written to the board, little endian
+} BoardTraceRecord;
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t capacity;
+	uint64_t head;			// number of records written so far, the next record goes to head % capacity
+} BoardTraceHeader;
+
+// Mapped trace of one board, part of its connection. Every thread using the connection records into it while
+// holding the connection, so the transactions of pollers are traced as well.
+typedef struct
+{
+	BoardTraceHeader *header;	// NULL while the trace is closed
+	BoardTraceRecord *records;
+	size_t size;				// size of the mapping in bytes
+} BoardTrace;
+
+int openBoardTrace(BoardTrace *trace, char *fileName, uint32_t capacity);
+void closeBoardTrace(BoardTrace *trace);
+int isBoardTraceOpen(BoardTrace *trace);
+void traceBoardTransaction(BoardTrace *trace, const unsigned char *frame, const char *reply, uint64_t start,
+		uint64_t end, int retries, int status);
+
+#endif /* BOARD_TRACE_H_ */
@@ -0,0 +1,282 @@
+/**
+ * @file comm_pipeline.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Pipelined request/response transport for the ASA Board
+ *
+ * @details controlBoardCommWR sends one frame and blocks until its reply arrived, so every item costs a full
+ *	network round trip. The pipeline queues several encoded frames, sends them with a single send() call and
+ *	matches the replies to the requests in order. The board answers frames strictly in the order it received
+ *	them over the TCP stream, therefore the n-th reply always belongs to the n-th frame in flight.
+ *	Requests are completed through their callback, or can be waited for like a future with pipelineWait.
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "comm_pipeline.h"
+#include "socket_utils.h"
+#include "board_trace.h"
+#include "comm_stats.h"
+#include "common_utils.h"
+#include "transport.h"
+#include "logz.h"
+
+
+/**
+ * @brief Initialises an empty pipeline for the given connection
+ * @param pipeline Pipeline to initialise
+ * @param connection Connected board
+ */
+void pipelineInit(CommPipeline *pipeline, BoardConnection *connection){
+	pipeline->connection = connection;
+	pipeline->count = 0;
+	pipeline->sent = 0;
+	pipeline->rxFill = 0;
+}
+
+
+/**
+ * Encodes the frame of a request and resets its completion state. The request can be submitted afterwards.
+ *
+ * @param request Request to prepare
+ * @param function Send function as used by encode (length, function code, parameters)
+ * @param expectedBytes Number of expected payload bytes of the reply, 0 for a plain acknowledge
+ * @param callback Function called on completion, may be NULL
+ * @param userData Pointer handed to the callback
+ * @return 0 on success, 1 if the reply does not fit into the request
+ */
+int pipelinePrepare(CommRequest *request, unsigned char *function, size_t expectedBytes,
+		CommCallback callback, void *userData){
+	unsigned char frame[FRAME_SIZE] = { 0 };
+	encode(frame, function);
+	return pipelinePrepareFrame(request, frame, expectedBytes, callback, userData);
+}
+
+
+/**
+ * Same as pipelinePrepare, but takes a frame which was already encoded, e.g. the read frame of an item handle.
+ *
+ * @param request Request to prepare
+ * @param frame Encoded frame of FRAME_SIZE bytes
+ * @param expectedBytes Number of expected payload bytes of the reply, 0 for a plain acknowledge
+ * @param callback Function called on completion, may be NULL
+ * @param userData Pointer handed to the callback
+ * @return 0 on success, 1 if the reply does not fit into the request
+ */
+int pipelinePrepareFrame(CommRequest *request, const unsigned char *frame, size_t expectedBytes,
+		CommCallback callback, void *userData){
+	size_t replySize = ACK_FRAME_SIZE;
+	if(expectedBytes > 0){
+		replySize = replyFrameSize(expectedBytes);
+	}
+	if(replySize > PIPELINE_MAX_REPLY){
+		fprintf(stderr,"Reply of %u bytes exceeds the pipeline reply buffer\n",(unsigned)replySize);
+		return 1;
+	}
+	memcpy(request->frame, frame, FRAME_SIZE);
+	request->expectedBytes = expectedBytes;
+	request->replySize = replySize;
+	request->status = COMM_PENDING;
+	request->retries = 0;
+	request->sentAt = 0;
+	request->callback = callback;
+	request->userData = userData;
+	return 0;
+}
+
+
+/**
+ * @brief Completes a request and informs its owner
+ * @param pipeline Pipeline the request was queued in
+ * @param request Completed request
+ * @param status 0 on success, 1 on failure
+ */
+static void completeRequest(CommPipeline *pipeline, CommRequest *request, int status){
+	uint64_t now = monotonicNs();
+	request->status = status;
+	countCommTransaction(&pipeline->connection->stats, request->frame[1], now - request->sentAt, status);
+	traceBoardTransaction(&pipeline->connection->trace, request->frame, request->reply, request->sentAt, now, request->retries, status);
+	if(request->callback != NULL){
+		request->callback(request, request->userData);
+	}
+}
+
+
+/**
+ * @brief Fails all queued requests still pending, used if the connection is lost
+ * @param pipeline Pipeline to abort
+ */
+static void abortPipeline(CommPipeline *pipeline){
+	for(size_t i = 0; i < pipeline->count; i++){
+		if(pipeline->queue[i]->status == COMM_PENDING){
+			completeRequest(pipeline, pipeline->queue[i], 1);
+		}
+	}
+	pipeline->count = 0;
+	pipeline->sent = 0;
+	pipeline->rxFill = 0;
+}
+
+
+/**
+ * Sends all queued frames, which are not yet in flight, with a single send call.
+ *
+ * @param pipeline Pipeline holding the frames
+ * @return 0 on success, 1 if sending failed
+ */
+static int sendPending(CommPipeline *pipeline){
+	size_t length = 0;
+	uint64_t now = monotonicNs();
+	for(size_t i = pipeline->sent; i < pipeline->count; i++){
+		CommRequest *request = pipeline->queue[i];
+		memcpy(&pipeline->txBuffer[length], request->frame, FRAME_SIZE);
+		length += FRAME_SIZE;
+		if(request->sentAt == 0){
+			request->sentAt = now;
+		}
+	}
+
+	size_t totalBytesSend = 0;
+	while(totalBytesSend < length){
+		int bytesSend = transportSend(pipeline->connection->socket, (char*) &pipeline->txBuffer[totalBytesSend],
+				length - totalBytesSend);
+		if(bytesSend <= 0){
+			logz("Board Communication failed. ERROR: Pipelined send failed");
+			return 1;
+		}
+		totalBytesSend += bytesSend;
+	}
+	countBytesSent(&pipeline->connection->stats, totalBytesSend);
+	pipeline->sent = pipeline->count;
+	return 0;
+}
+
+
+/**
+ * Receives the replies of all frames in flight. Replies are matched to the requests in sending order,
+ * every reply is checked for its CRC and the echoed function code. Successful requests are completed as soon
+ * as their reply arrived. From the first failed reply on, all requests keep their pending state for a retry,
+ * the replies behind it are only consumed.
+ *
+ * @param pipeline Pipeline holding the requests in flight
+ * @return 0 if all replies were received, 1 if the connection failed
+ */
+static int receivePending(CommPipeline *pipeline){
+	size_t expectedTotal = 0;
+	for(size_t i = 0; i < pipeline->sent; i++){
+		expectedTotal += pipeline->queue[i]->replySize;
+	}
+
+	size_t head = 0;
+	size_t consumed = 0;
+	int failed = 0;
+	pipeline->rxFill = 0;
+	while(head < pipeline->sent){
+		int bytesRead = transportRecv(pipeline->connection->socket, &pipeline->rxBuffer[pipeline->rxFill],
+				expectedTotal - pipeline->rxFill);
+		if(bytesRead == 0){
+			logz("Board Read Operation failed: Connection closed by the server.");
+			return 1;
+		}else if(bytesRead < 0){
+			logz("Board Read Operation failed: Failed to receive pipelined data from the server.");
+			return 1;
+		}
+		pipeline->rxFill += bytesRead;
+		countBytesReceived(&pipeline->connection->stats, bytesRead);
+
+		while(head < pipeline->sent && consumed + pipeline->queue[head]->replySize <= pipeline->rxFill){
+			CommRequest *request = pipeline->queue[head];
+			char *reply = &pipeline->rxBuffer[consumed];
+			memcpy(request->reply, reply, request->replySize);
+			if(failed){
+				// discarded, the request is sent again behind the failed one
+			}else if(checkReplyChecksum(reply, request->replySize) != 0){
+				countCrcError(&pipeline->connection->stats);
+				failed = 1;
+			}else if((unsigned char) reply[0] == request->frame[1]){
+				completeRequest(pipeline, request, 0);
+			}else{
+				countFunctionError(&pipeline->connection->stats);
+				failed = 1;
+			}
+			consumed += request->replySize;
+			head++;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * Queues a prepared request. If the pipeline is full, the queued requests are flushed first.
+ *
+ * @param pipeline Pipeline to queue the request in
+ * @param request Prepared request, has to stay valid until it is completed
+ * @return 0 on success, 1 if flushing a full pipeline failed
+ */
+int pipelineSubmit(CommPipeline *pipeline, CommRequest *request){
+	int error = 0;
+	if(pipeline->count == PIPELINE_DEPTH){
+		error = pipelineFlush(pipeline);
+	}
+	pipeline->queue[pipeline->count++] = request;
+	return error;
+}
+
+
+/**
+ * Sends all queued frames in one burst and completes them once their replies arrived.
+ * Retries are go-back-N: if a reply fails the CRC or function check, the failed request and all requests
+ * behind it are sent again in their original order, up to PIPELINE_MAX_RETRIES attempts in total. If the
+ * failed request runs out of attempts, it and all requests behind it fail.
+ *
+ * @param pipeline Pipeline to flush
+ * @return 0 if all requests succeeded, 1 if at least one request failed
+ */
+int pipelineFlush(CommPipeline *pipeline){
+	while(pipeline->count > 0){
+		if(sendPending(pipeline) == 1 || receivePending(pipeline) == 1){
+			abortPipeline(pipeline);
+			return 1;
+		}
+
+		size_t first = 0;
+		while(first < pipeline->count && pipeline->queue[first]->status != COMM_PENDING){
+			first++;
+		}
+		size_t retryCount = pipeline->count - first;
+		pipeline->sent = 0;
+		if(retryCount > 0 && pipeline->queue[first]->retries + 1 >= PIPELINE_MAX_RETRIES){
+			logz("Board Pipelined Operation: Data transmission failed (CRC Error)");
+			for(size_t i = first; i < pipeline->count; i++){
+				completeRequest(pipeline, pipeline->queue[i], 1);
+			}
+			pipeline->count = 0;
+			return 1;
+		}
+		if(retryCount > 0){
+			pipeline->queue[first]->retries++;
+			countRetry(&pipeline->connection->stats);
+			memmove(&pipeline->queue[0], &pipeline->queue[first], retryCount * sizeof(CommRequest*));
+		}
+		pipeline->count = retryCount;
+	}
+	return 0;
+}
+
+
+/**
+ * Waits for the completion of a single request, flushing the pipeline if the request is still queued.
+ *
+ * @param pipeline Pipeline the request was submitted to
+ * @param request Request to wait for
+ * @return 0 if the request succeeded, 1 otherwise
+ */
+int pipelineWait(CommPipeline *pipeline, CommRequest *request){
+	if(request->status == COMM_PENDING){
+		pipelineFlush(pipeline);
+	}
+	return request->status == 0 ? 0 : 1;
+}
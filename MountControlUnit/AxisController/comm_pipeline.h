@@ -0,0 +1,69 @@
+/*
+ * comm_pipeline.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef COMM_PIPELINE_H_
+#define COMM_PIPELINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "board_connection.h"
+
+#define FRAME_SIZE 16
+#define PIPELINE_DEPTH 32
+#define PIPELINE_MAX_REPLY 128
+#define PIPELINE_MAX_RETRIES 3
+
+// A write acknowledge carries no payload, only the echoed function code and the checksum
+#define ACK_FRAME_SIZE 2
+
+#define COMM_PENDING (-1)
+
+typedef struct CommRequest CommRequest;
+
+// Called once a request is completed, either successfully or after all retries failed
+typedef void (*CommCallback)(CommRequest *request, void *userData);
+
+struct CommRequest
+{
+	unsigned char frame[FRAME_SIZE];
+	char reply[PIPELINE_MAX_REPLY];
+	size_t expectedBytes;
+	size_t replySize;
+	int status;		// COMM_PENDING while in flight, 0 on success, 1 on failure
+	int retries;		// failed transmissions, requests sent again behind a failed one don't count
+	uint64_t sentAt;	// monotonic time of the first transmission in ns, 0 until sent
+	CommCallback callback;
+	void *userData;
+};
+
+// Ordering: the board executes the frames of a pipeline in the order they were submitted, and requests are
+// completed in that order. A request is only completed successfully after every request submitted before it
+// succeeded. If a reply fails its check, the failed request and every request behind it are sent again in the
+// original order (go-back-N). The board may therefore execute those requests twice, and a repeated read can
+// already see a write submitted behind it in the same burst. Callers depending on a read seeing the state
+// before such a write check the retries of all requests of the burst, or flush before queueing the write.
+typedef struct
+{
+	BoardConnection *connection;
+	CommRequest *queue[PIPELINE_DEPTH];
+	size_t count;
+	size_t sent;
+	unsigned char txBuffer[PIPELINE_DEPTH * FRAME_SIZE];
+	char rxBuffer[PIPELINE_DEPTH * PIPELINE_MAX_REPLY];
+	size_t rxFill;
+} CommPipeline;
+
+void pipelineInit(CommPipeline *pipeline, BoardConnection *connection);
+int pipelinePrepare(CommRequest *request, unsigned char *function, size_t expectedBytes,
+		CommCallback callback, void *userData);
+int pipelinePrepareFrame(CommRequest *request, const unsigned char *frame, size_t expectedBytes,
+		CommCallback callback, void *userData);
+int pipelineSubmit(CommPipeline *pipeline, CommRequest *request);
+int pipelineFlush(CommPipeline *pipeline);
+int pipelineWait(CommPipeline *pipeline, CommRequest *request);
+
+#endif /* COMM_PIPELINE_H_ */
@@ -0,0 +1,193 @@
+/**
+ * @file comm_stats.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Latency histograms and counters of the board communication
+ *
+ * @details controlBoardCommWR and the pipeline count every transaction, its round trip time per function code,
+ *	checksum and function code errors, retries and the bytes sent and received. The round trip time is taken
+ *	from sending the frame until its reply is complete, for pipelined requests from sending the burst.
+ *	Latencies are kept in HDR-style log-linear histograms, recording is a few instructions and never allocates.
+ *	Every connection counts into its own statistics, they can be dumped at any time from the thread using it.
+ **/
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "comm_stats.h"
+
+static const char *functionNames[COMM_FUNCTION_COUNT] = {
+	"status", "item count", "describe", "write RAM", "read RAM"
+};
+
+
+/**
+ * @brief Maps a latency to its bucket
+ * @param latency Latency in ns
+ * @return Index of the bucket
+ */
+static size_t getLatencyBucket(uint64_t latency){
+	if(latency < LATENCY_SUB_BUCKETS){
+		return latency;
+	}
+	int shift = 63 - __builtin_clzll(latency) - LATENCY_SUB_BITS;
+	if(shift > LATENCY_MAX_SHIFT){
+		return LATENCY_BUCKETS - 1;
+	}
+	return (size_t)shift * LATENCY_SUB_BUCKETS + (size_t)(latency >> shift);
+}
+
+
+/**
+ * @brief Calculates the highest latency counted in a bucket
+ * @param bucket Index of the bucket
+ * @return Upper bound of the bucket in ns
+ */
+static uint64_t getBucketLimit(size_t bucket){
+	if(bucket < 2 * LATENCY_SUB_BUCKETS){
+		return bucket;
+	}
+	int shift = bucket / LATENCY_SUB_BUCKETS - 1;
+	uint64_t lower = (uint64_t)(bucket - (size_t)shift * LATENCY_SUB_BUCKETS) << shift;
+	return lower + ((uint64_t)1 << shift) - 1;
+}
+
+
+/**
+ * @brief Adds a latency to a histogram
+ * @param histogram Histogram to add to
+ * @param latency Latency in ns
+ */
+void recordLatency(LatencyHistogram *histogram, uint64_t latency){
+	if(histogram->count == 0 || latency < histogram->min){
+		histogram->min = latency;
+	}
+	if(latency > histogram->max){
+		histogram->max = latency;
+	}
+	histogram->count++;
+	histogram->sum += latency;
+	histogram->buckets[getLatencyBucket(latency)]++;
+}
+
+
+/**
+ * Determines the latency below which the given share of all recorded latencies lies. The result is exact to the
+ * width of a bucket (6.25%).
+ *
+ * @param histogram Histogram to evaluate
+ * @param percentile Percentile between 0 and 100
+ * @return Latency in ns, 0 if the histogram is empty
+ */
+uint64_t getLatencyPercentile(LatencyHistogram *histogram, double percentile){
+	if(histogram->count == 0){
+		return 0;
+	}
+	uint64_t rank = (uint64_t)(percentile / 100.0 * histogram->count + 0.5);
+	if(rank < 1){
+		rank = 1;
+	}
+	uint64_t counted = 0;
+	for(size_t i = 0; i < LATENCY_BUCKETS; i++){
+		counted += histogram->buckets[i];
+		if(counted >= rank){
+			uint64_t limit = getBucketLimit(i);
+			return limit > histogram->max ? histogram->max : limit;
+		}
+	}
+	return histogram->max;
+}
+
+
+/**
+ * @brief Counts a completed transaction
+ * @param stats Statistics of the connection
+ * @param function Function code of the frame
+ * @param latency Round trip time in ns, only recorded for successful transactions
+ * @param status 0 on success, 1 on failure
+ */
+void countCommTransaction(CommStats *stats, unsigned char function, uint64_t latency, int status){
+	stats->transactions++;
+	if(status != 0){
+		stats->failures++;
+	}else if(function < COMM_FUNCTION_COUNT){
+		recordLatency(&stats->latency[function], latency);
+	}
+}
+
+
+void countCrcError(CommStats *stats){
+	stats->crcErrors++;
+}
+
+
+void countFunctionError(CommStats *stats){
+	stats->functionErrors++;
+}
+
+
+void countRetry(CommStats *stats){
+	stats->retries++;
+}
+
+
+void countBytesSent(CommStats *stats, size_t bytes){
+	stats->bytesSent += bytes;
+}
+
+
+void countBytesReceived(CommStats *stats, size_t bytes){
+	stats->bytesReceived += bytes;
+}
+
+
+void countShadowHit(CommStats *stats){
+	stats->shadowHits++;
+}
+
+
+void countSuppressedWrite(CommStats *stats){
+	stats->suppressedWrites++;
+}
+
+
+/**
+ * @brief Clears all counters and histograms
+ * @param stats Statistics to clear
+ */
+void resetCommStats(CommStats *stats){
+	memset(stats, 0, sizeof(CommStats));
+}
+
+
+/**
+ * Prints the counters and a latency summary per function code. Latencies are printed in us.
+ *
+ * @param stats Statistics of the connection
+ * @param stream Stream to print to, e.g. stdout or a file
+ */
+void dumpCommStats(CommStats *stats, FILE *stream){
+	fprintf(stream, "Board communication: %" PRIu64 " transactions, %" PRIu64 " failed, %" PRIu64 " retries\n",
+			stats->transactions, stats->failures, stats->retries);
+	fprintf(stream, "Errors: %" PRIu64 " CRC, %" PRIu64 " function code\n",
+			stats->crcErrors, stats->functionErrors);
+	fprintf(stream, "Bytes: %" PRIu64 " sent, %" PRIu64 " received\n", stats->bytesSent, stats->bytesReceived);
+	fprintf(stream, "Bit writes: %" PRIu64 " from shadow, %" PRIu64 " suppressed\n",
+			stats->shadowHits, stats->suppressedWrites);
+	fprintf(stream, "%-12s %10s %10s %10s %10s %10s %10s %10s %10s\n",
+			"function", "count", "min", "mean", "p50", "p90", "p99", "p99.9", "max");
+	for(int i = 0; i < COMM_FUNCTION_COUNT; i++){
+		LatencyHistogram *histogram = &stats->latency[i];
+		if(histogram->count == 0){
+			continue;
+		}
+		fprintf(stream, "%-12s %10" PRIu64 " %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+				functionNames[i], histogram->count, histogram->min / 1000.0,
+				(double)histogram->sum / histogram->count / 1000.0,
+				getLatencyPercentile(histogram, 50.0) / 1000.0, getLatencyPercentile(histogram, 90.0) / 1000.0,
+				getLatencyPercentile(histogram, 99.0) / 1000.0, getLatencyPercentile(histogram, 99.9) / 1000.0,
+				histogram->max / 1000.0);
+	}
+	fflush(stream);
+}
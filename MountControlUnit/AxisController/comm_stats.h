@@ -0,0 +1,63 @@
+/*
+ * comm_stats.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef COMM_STATS_H_
+#define COMM_STATS_H_
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define COMM_FUNCTION_COUNT 5		// status, item count, describe, write RAM, read RAM
+
+// Latencies are counted in log-linear buckets: every power of two is split into LATENCY_SUB_BUCKETS buckets,
+// so every bucket is at most 1/16 (6.25%) wide relative to its value. Covers latencies below
+// 2^(LATENCY_MAX_SHIFT + LATENCY_SUB_BITS + 1) ns, 2^41 ns or about 36 minutes, longer ones are counted in the last bucket.
+#define LATENCY_SUB_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_SHIFT 36
+#define LATENCY_BUCKETS ((LATENCY_MAX_SHIFT + 2) * LATENCY_SUB_BUCKETS)
+
+typedef struct
+{
+	uint64_t count;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+	uint32_t buckets[LATENCY_BUCKETS];
+} LatencyHistogram;
+
+typedef struct
+{
+	LatencyHistogram latency[COMM_FUNCTION_COUNT];	// round trip time of successful transactions in ns
+	uint64_t transactions;
+	uint64_t failures;			// transactions which failed after all retries
+	uint64_t crcErrors;			// replies failing the checksum check
+	uint64_t functionErrors;	// replies not echoing the function code of the frame
+	uint64_t retries;
+	uint64_t bytesSent;
+	uint64_t bytesReceived;
+	uint64_t shadowHits;		// bit writes merged into a shadow word instead of reading the board
+	uint64_t suppressedWrites;	// bit writes not sent because they left the shadow word unchanged
+} CommStats;
+
+void recordLatency(LatencyHistogram *histogram, uint64_t latency);
+uint64_t getLatencyPercentile(LatencyHistogram *histogram, double percentile);
+
+void countCommTransaction(CommStats *stats, unsigned char function, uint64_t latency, int status);
+void countCrcError(CommStats *stats);
+void countFunctionError(CommStats *stats);
+void countRetry(CommStats *stats);
+void countBytesSent(CommStats *stats, size_t bytes);
+void countBytesReceived(CommStats *stats, size_t bytes);
+void countShadowHit(CommStats *stats);
+void countSuppressedWrite(CommStats *stats);
+
+void resetCommStats(CommStats *stats);
+void dumpCommStats(CommStats *stats, FILE *stream);
+
+#endif /* COMM_STATS_H_ */
@@ -6,13 +6,12 @@
  */
 
 #include <stdio.h>
-#include <conio.h>
 #include <unistd.h>
 #include <string.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <windows.h>
+#include <sys/stat.h>
 #include "common_utils.h"
 
 void error_handler(char* error){
@@ -91,17 +90,27 @@ void doubleToCharArray(double value, char* charArray,size_t size) {
 	uint32ToCharArray(tempi, charArray, size);
 }
 
-void sleep_us(int microseconds) {
-	// Use busy-wait loop for microsecond precision
-	LARGE_INTEGER frequency, start, current;
-	QueryPerformanceFrequency(&frequency);
-	QueryPerformanceCounter(&start);
+#ifdef POSIX_BACKEND
 
-	do {
-		QueryPerformanceCounter(&current);
-	} while ((current.QuadPart - start.QuadPart) * 1000000 / frequency.QuadPart < microseconds);
+int createDirectory(const char *path) {
+	struct stat status;
+	if (stat(path, &status) == 0) {
+		return 0;
+	}
+	return mkdir(path, 0777) == 0 ? 0 : 1;
 }
 
+#else
+
+int createDirectory(const char *path) {
+	if (GetFileAttributes(path) != INVALID_FILE_ATTRIBUTES) {
+		return 0;
+	}
+	return CreateDirectory(path, NULL) ? 0 : 1;
+}
+
+#endif
+
 
 void printBitsInt(int16_t num) {
     int i;
@@ -132,3 +141,15 @@ void printBits(uint32_t num) {
 }
 
 
+
+uint32_t crc32Update(uint32_t crc, const void *data, size_t length) {
+    const unsigned char *bytes = data;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
@@ -9,13 +9,13 @@
 #define COMMON_UTILS_H
 
 #include <stdio.h>
-#include <conio.h>
 #include <unistd.h>
 #include <string.h>
 #include <math.h>
 #include <stdint.h>
-#include <windows.h>
+#include "sockets.h"
 #include "thread_utils.h"
+#include "timing_utils.h"
 
 // Define PATH_SEPARATOR based on the operating system
 #ifdef _WIN32
@@ -51,8 +51,8 @@ int byteArrayToFloat(const char* byteArray, float* result);
 // Convert a double to a char array
 void doubleToCharArray(double value, char* charArray, size_t size);
 
-// Sleep for a specified number of microseconds
-void sleep_us(int microseconds);
+// Create a directory if it doesn't exist yet
+int createDirectory(const char *path);
 
 // Print the bits of an int16_t
 void printBitsInt(int16_t num);
@@ -60,4 +60,7 @@ void printBitsInt(int16_t num);
 // Print the bits of a uint32_t
 void printBits(uint32_t num);
 
+// Continue a CRC-32 over the given bytes, start with crc = 0
+uint32_t crc32Update(uint32_t crc, const void *data, size_t length);
+
 #endif // COMMON_UTILS_H
@@ -0,0 +1,370 @@
+/**
+ * @file item_handle.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Pre-resolved handles for board items
+ *
+ * @details The name based functions of socket_utils split the "item.bit" name, look the item up and encode the
+ *	frame on every call. Loops polling the same items every few milliseconds resolve them once with resolveItem
+ *	instead. The handle holds the encoded read frame, the address, the length type and the bit mask and shift of
+ *	bit items, so reading and writing through a handle does no string work and no allocation.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "item_handle.h"
+#include "comm_pipeline.h"
+#include "socket_utils.h"
+#include "vlitem_handler.h"
+#include "common_utils.h"
+#include "logz.h"
+
+struct ItemHandle
+{
+	VLItem *item;
+	int index;			// position of the item in the VLItem cache, selects its shadow word
+	unsigned char readFrame[FRAME_SIZE];	// encoded read RAM frame of the whole item
+	unsigned char address[3];
+	char lenTyp;
+	size_t size;		// item size in bytes
+	int isBitItem;
+	uint32_t mask;		// mask of the bit item within the item data, not shifted
+	uint32_t shift;		// start bit of the bit item
+};
+
+
+/**
+ * Resolves an item or bit item in dot-notation (e.g., "item.field") into a handle. Name validation, the item
+ * lookup and the encoding of the read frame are done once here. Like writeToBoard, plain items consisting of
+ * bit items are rejected.
+ *
+ * @param connection Connection to the board the item belongs to.
+ * @param input Item name, optionally followed by '.' and a bit item name.
+ * @param handle Pointer to store the allocated handle, release it with releaseItem.
+ * @return 0 on success, 1 if the item or bit item doesn't exist.
+ */
+int resolveItem(BoardConnection *connection, const char *input, ItemHandle **handle){
+	char itemName[sizeof(((VLItem*)0)->name)];
+	char bitName[sizeof(((BitItem*)0)->bitName)];
+	VLItem *item;
+	BitItem *bitItem = NULL;
+
+	if(splitItemName(input, itemName, bitName) == 1 || getVLItem(connection, &item, itemName) == 1){
+		return 1;
+	}
+	if(bitName[0] != '\0'){
+		if(item->BitItemCount <= 0 || getBitItemFromVlItem(item, bitName, &bitItem) == 1){
+			sprintf(connection->message,"Resolve Item: failed. Error: BitItem (%s) not found in Item (%s).",bitName,itemName);
+			logz(connection->message);
+			return 1;
+		}
+	}else if(item->BitItemCount > 0){
+		sprintf(connection->message,"Resolve Item: failed. Error: Item (%s) consists of BitItems. Provide BitItem like \"itemName.bitName\"",itemName);
+		logz(connection->message);
+		return 1;
+	}
+
+	ItemHandle *newHandle = malloc(sizeof(ItemHandle));
+	if(newHandle == NULL){
+		fprintf(stderr,"Memory allocation for item handle failed\n");
+		return 1;
+	}
+	newHandle->item = item;
+	newHandle->index = getVlItemIndex(&connection->items, item);
+	memcpy(newHandle->address, item->Address, sizeof(newHandle->address));
+	newHandle->lenTyp = item->LenTyp[0];
+	newHandle->size = lenTypToByte(item->LenTyp[0]);
+	newHandle->isBitItem = bitItem != NULL;
+	newHandle->mask = 0xFFFFFFFF;
+	newHandle->shift = 0;
+	if(bitItem != NULL){
+		newHandle->mask = bitItem->size >= 32 ? 0xFFFFFFFF : (1u << bitItem->size) - 1;
+		newHandle->shift = bitItem->startBit;
+	}
+
+	unsigned char readRam[] = { 5, 4, 0, 0, 0, 0 };
+	memcpy(&readRam[2], newHandle->address, sizeof(newHandle->address));
+	readRam[5] = newHandle->size;
+	memset(newHandle->readFrame, 0, FRAME_SIZE);
+	encode(newHandle->readFrame, readRam);
+
+	*handle = newHandle;
+	return 0;
+}
+
+
+/**
+ * @brief Releases a handle returned by resolveItem
+ * @param handle Handle to release, may be NULL
+ */
+void releaseItem(ItemHandle *handle){
+	free(handle);
+}
+
+
+/**
+ * Reads the raw data of the whole item the handle refers to.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved item.
+ * @param raw Pointer to store the item data.
+ * @return 0 on success, 1 on failure.
+ */
+static int readRaw(BoardConnection *connection, ItemHandle *handle, uint32_t *raw){
+	char receivedDataBuffer[DEFAULT_BUFLEN];
+	if(controlBoardCommWR(connection, handle->readFrame, receivedDataBuffer, FRAME_SIZE, handle->size) == 1){
+		return 1;
+	}
+	if(charArrayToUint32(&receivedDataBuffer[1], handle->size, raw) == 1){
+		return 1;
+	}
+	setShadowRegister(&connection->shadows, handle->index, *raw);
+	return 0;
+}
+
+
+/**
+ * @brief Extracts the value of a handle from the raw item data
+ * @param handle Resolved item.
+ * @param raw Raw item data.
+ * @return Value of the item or bit item.
+ */
+static uint32_t extractValue(ItemHandle *handle, uint32_t raw){
+	return (raw >> handle->shift) & handle->mask;
+}
+
+
+/**
+ * Reads an item or bit item through its handle. Plain items are returned as raw, zero extended data,
+ * bit items as the value of their bit field.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved item.
+ * @param value Pointer to store the read value.
+ * @return 0 on success, 1 on failure.
+ */
+int readItem(BoardConnection *connection, ItemHandle *handle, uint32_t *value){
+	uint32_t raw;
+	if(readRaw(connection, handle, &raw) == 1){
+		return 1;
+	}
+	*value = extractValue(handle, raw);
+	return 0;
+}
+
+
+/**
+ * Reads a float item through its handle.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved float item.
+ * @param value Pointer to store the read value.
+ * @return 0 on success, 1 on failure or if the item isn't a float.
+ */
+int readItemFloat(BoardConnection *connection, ItemHandle *handle, float *value){
+	uint32_t raw;
+	if(handle->lenTyp != 12 || handle->isBitItem){
+		fprintf(stderr,"Wrong data type. Item %s need data type %d.",handle->item->name,handle->lenTyp);
+		fflush(stderr);
+		return 1;
+	}
+	if(readRaw(connection, handle, &raw) == 1){
+		return 1;
+	}
+	memcpy(value, &raw, sizeof(float));
+	return 0;
+}
+
+
+/**
+ * Reads several items in pipelined bursts of PIPELINE_DEPTH frames, using the encoded read frames of the handles.
+ *
+ * @param connection Connection to the board.
+ * @param handles Resolved items.
+ * @param values Array to store the values, as returned by readItem.
+ * @param status Array to store the status of every read, 0 on success, 1 on failure. May be NULL.
+ * @param count Number of items to read.
+ * @return 0 if all items were read successfully, 1 if at least one read failed.
+ */
+int readItemMany(BoardConnection *connection, ItemHandle *handles[], uint32_t values[], int status[], size_t count){
+	CommPipeline pipeline;
+	CommRequest requests[PIPELINE_DEPTH];
+	int error = 0;
+
+	pipelineInit(&pipeline, connection);
+	for(size_t chunk = 0; chunk < count; chunk += PIPELINE_DEPTH){
+		size_t chunkSize = count - chunk;
+		if(chunkSize > PIPELINE_DEPTH){
+			chunkSize = PIPELINE_DEPTH;
+		}
+		for(size_t i = 0; i < chunkSize; i++){
+			pipelinePrepareFrame(&requests[i], handles[chunk + i]->readFrame, handles[chunk + i]->size, NULL, NULL);
+			pipelineSubmit(&pipeline, &requests[i]);
+		}
+		if(pipelineFlush(&pipeline) == 1){
+			error = 1;
+		}
+		for(size_t i = 0; i < chunkSize; i++){
+			ItemHandle *handle = handles[chunk + i];
+			uint32_t raw;
+			int failed = requests[i].status != 0
+					|| charArrayToUint32(&requests[i].reply[1], handle->size, &raw) == 1;
+			if(failed){
+				error = 1;
+			}else{
+				setShadowRegister(&connection->shadows, handle->index, raw);
+				values[chunk + i] = extractValue(handle, raw);
+			}
+			if(status != NULL){
+				status[chunk + i] = failed;
+			}
+		}
+	}
+	return error;
+}
+
+
+/**
+ * Writes the whole item data of a handle with a write RAM frame. The data becomes the shadow word of the item,
+ * a failed write drops it.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved item.
+ * @param raw Item data to write.
+ * @return 0 on success, 1 on failure.
+ */
+static int writeRaw(BoardConnection *connection, ItemHandle *handle, uint32_t raw){
+	unsigned char writeRam[9] = { 0 };
+	unsigned char sendData[FRAME_SIZE] = { 0 };
+	char receivedDataBuffer[DEFAULT_BUFLEN];
+
+	writeRam[0] = 4 + handle->size;
+	writeRam[1] = 3;
+	memcpy(&writeRam[2], handle->address, sizeof(handle->address));
+	uint32ToCharArray(raw, (char*) &writeRam[5], handle->size);
+	encode(sendData, writeRam);
+	if(controlBoardCommWR(connection, sendData, receivedDataBuffer, FRAME_SIZE, 0) == 1){
+		invalidateShadowRegister(&connection->shadows, handle->index);
+		return 1;
+	}
+	setShadowRegister(&connection->shadows, handle->index, raw);
+	return 0;
+}
+
+
+/**
+ * Writes an item or bit item through its handle. Bit items are merged into the current item data, so the other
+ * bit items keep their values. The item data is taken from the shadow word and only read from the board, if the
+ * shadow word is older than the resync period. A bit write leaving the data unchanged is not sent, if
+ * suppressRedundant is set.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved item.
+ * @param value Value to write, the value of the bit field for bit items.
+ * @return 0 on success, 1 on failure or if the value doesn't fit into the bit item.
+ */
+int writeItem(BoardConnection *connection, ItemHandle *handle, uint32_t value){
+	if(!handle->isBitItem){
+		return writeRaw(connection, handle, value);
+	}
+	if(value > handle->mask){
+		fprintf(stderr,"Data not possible to send. Data to big. MaxSize for %s is: %u. Data size tried to send %u\n",
+				handle->item->name, handle->mask, value);
+		fflush(stderr);
+		return 1;
+	}
+	uint32_t raw;
+	if(getShadowRegister(&connection->shadows, handle->index, &raw) == 0){
+		countShadowHit(&connection->stats);
+	}else if(readRaw(connection, handle, &raw) == 1){
+		return 1;
+	}
+	uint32_t bitMask = handle->mask << handle->shift;
+	uint32_t merged = (raw & ~bitMask) | ((value << handle->shift) & bitMask);
+	if(connection->shadows.suppressRedundant && merged == raw){
+		countSuppressedWrite(&connection->stats);
+		return 0;
+	}
+	return writeRaw(connection, handle, merged);
+}
+
+
+/**
+ * Writes a float item through its handle.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved float item.
+ * @param value Value to write.
+ * @return 0 on success, 1 on failure or if the item isn't a float.
+ */
+int writeItemFloat(BoardConnection *connection, ItemHandle *handle, float value){
+	uint32_t raw;
+	if(handle->lenTyp != 12 || handle->isBitItem){
+		fprintf(stderr,"Wrong data type. Item %s need data type %d.",handle->item->name,handle->lenTyp);
+		fflush(stderr);
+		return 1;
+	}
+	memcpy(&raw, &value, sizeof(float));
+	return writeRaw(connection, handle, raw);
+}
+
+
+/**
+ * Prepares a pipeline request reading an item through its handle, so reads and writes of several handles can be
+ * mixed in one burst. Decode the reply with getItemValue.
+ *
+ * @param handle Resolved item.
+ * @param request Request to prepare, submit it to a pipeline afterwards.
+ * @return 0 on success, 1 on failure.
+ */
+int prepareItemRead(ItemHandle *handle, CommRequest *request){
+	return pipelinePrepareFrame(request, handle->readFrame, handle->size, NULL, NULL);
+}
+
+
+/**
+ * Prepares a pipeline request writing a plain item through its handle. The shadow word of the item is dropped,
+ * the board state is only known once the request completed.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved plain item, bit items need the current item data and can't be written in a burst.
+ * @param request Request to prepare, submit it to a pipeline afterwards.
+ * @param value Value to write.
+ * @return 0 on success, 1 on failure or if the handle is a bit item.
+ */
+int prepareItemWrite(BoardConnection *connection, ItemHandle *handle, CommRequest *request, uint32_t value){
+	unsigned char writeRam[9] = { 0 };
+
+	if(handle->isBitItem){
+		return 1;
+	}
+	writeRam[0] = 4 + handle->size;
+	writeRam[1] = 3;
+	memcpy(&writeRam[2], handle->address, sizeof(handle->address));
+	uint32ToCharArray(value, (char*) &writeRam[5], handle->size);
+	invalidateShadowRegister(&connection->shadows, handle->index);
+	return pipelinePrepare(request, writeRam, 0, NULL, NULL);
+}
+
+
+/**
+ * Decodes the reply of a request prepared with prepareItemRead, like readItem.
+ *
+ * @param connection Connection to the board.
+ * @param handle Resolved item the request was prepared for.
+ * @param request Completed request.
+ * @param value Pointer to store the value.
+ * @return 0 on success, 1 if the request failed.
+ */
+int getItemValue(BoardConnection *connection, ItemHandle *handle, CommRequest *request, uint32_t *value){
+	uint32_t raw;
+	if(request->status != 0 || charArrayToUint32(&request->reply[1], handle->size, &raw) == 1){
+		return 1;
+	}
+	setShadowRegister(&connection->shadows, handle->index, raw);
+	*value = extractValue(handle, raw);
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * item_handle.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef ITEM_HANDLE_H_
+#define ITEM_HANDLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "board_connection.h"
+#include "comm_pipeline.h"
+
+// Opaque handle of a resolved item or bit item, see resolveItem
+typedef struct ItemHandle ItemHandle;
+
+int resolveItem(BoardConnection *connection, const char *input, ItemHandle **handle);
+void releaseItem(ItemHandle *handle);
+
+int readItem(BoardConnection *connection, ItemHandle *handle, uint32_t *value);
+int readItemFloat(BoardConnection *connection, ItemHandle *handle, float *value);
+int readItemMany(BoardConnection *connection, ItemHandle *handles[], uint32_t values[], int status[], size_t count);
+int writeItem(BoardConnection *connection, ItemHandle *handle, uint32_t value);
+int writeItemFloat(BoardConnection *connection, ItemHandle *handle, float value);
+
+int prepareItemRead(ItemHandle *handle, CommRequest *request);
+int prepareItemWrite(BoardConnection *connection, ItemHandle *handle, CommRequest *request, uint32_t value);
+int getItemValue(BoardConnection *connection, ItemHandle *handle, CommRequest *request, uint32_t *value);
+
+#endif /* ITEM_HANDLE_H_ */
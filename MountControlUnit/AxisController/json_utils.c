@@ -6,7 +6,7 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
-#include <conio.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <string.h>
 #include "json_utils.h"
@@ -40,6 +40,10 @@ int createFileStream(FILE **filePointer, char *fileName, char *privileges,int sh
     *filePointer = fopen(path, privileges);
 
     if (!*filePointer) {
+    	// the directory is only held while the file is open
+    	if(shared == 1){
+    		sem_post(&sharedDir);
+    	}
     	return 1;
     }
     return 0;
@@ -69,7 +73,7 @@ int closeFileStream(FILE *filePointer,int shared){
  * @brief Function to parse JSON data from a file and obtain the root cJSON object.
  *
  * This function reads JSON data from the provided file stream and parses it to obtain the root cJSON object.
- * It dynamically allocates memory for a buffer to read the JSON data from the file.
+ * It dynamically allocates a buffer of the file size and reads the JSON data with a single fread.
  * The memory for the buffer is freed after parsing is complete.
  *
  * @param root         Pointer to a pointer to a cJSON object where the root cJSON object will be stored.
@@ -77,32 +81,27 @@ int closeFileStream(FILE *filePointer,int shared){
  * @return             Returns 0 on success, 1 if an error occurs during memory allocation or JSON parsing.
  */
 int getJsonRoot(cJSON **root, FILE *filePointer) {
-    // Initialize buffer
-    char *json_buffer = NULL;
-    size_t buffer_size = 128;
-    size_t current_size = 0;
-    json_buffer = (char *)malloc(buffer_size);
+    // Determine the file size, the whole file is read with a single fread
+    if (fseek(filePointer, 0, SEEK_END) != 0) {
+        closeFileStream(filePointer,0);
+        fprintf(stderr,"Error reading JSON file\n");
+        return 1;
+    }
+    long file_size = ftell(filePointer);
+    rewind(filePointer);
+    if (file_size < 0) {
+        closeFileStream(filePointer,0);
+        fprintf(stderr,"Error reading JSON file\n");
+        return 1;
+    }
+
+    char *json_buffer = (char *)malloc(file_size + 1);
     if(json_buffer == NULL){
+        closeFileStream(filePointer,0);
     	fprintf(stderr,"Memory allocation error\n");
     	return 1;
     }
-    // Read the file character by character
-    int current_char;
-    while ((current_char = fgetc(filePointer)) != EOF) {
-        // Expand buffer if needed
-        if (current_size == buffer_size) {
-            buffer_size += 128;  // You can adjust this value based on your needs
-            json_buffer = (char *)realloc(json_buffer, buffer_size);
-            if (json_buffer == NULL) {
-            	closeFileStream(filePointer,0);
-                fprintf(stderr,"Memory allocation error\n");
-                return 1;
-            }
-        }
-
-        // Append character to buffer
-        json_buffer[current_size++] = (char)current_char;
-    }
+    size_t current_size = fread(json_buffer, 1, file_size, filePointer);
     //WARNING NO SEMAPHORE
     closeFileStream(filePointer,0);
 
@@ -538,19 +537,23 @@ int getVLItemFromJson(VLItem *item,char *input){
 	if(getJsonRoot(&vlItemRoot, vlItemFile)==1){
 		return 1;
 	}
-	closeFileStream(vlItemFile,0);
 
 	cJSON *vlitems = cJSON_GetObjectItem(vlItemRoot, "ItemData");
-	if(vlitems == NULL)return 1;
-	for (int i = 0; i < cJSON_GetArraySize(vlitems); i++) {
-		cJSON *vlItem = cJSON_GetArrayItem(vlitems, i);
+	if(vlitems == NULL){
+		cJSON_Delete(vlItemRoot);
+		return 1;
+	}
+	cJSON *vlItem = NULL;
+	cJSON_ArrayForEach(vlItem, vlitems) {
 		cJSON *vlItemName= cJSON_GetObjectItem(vlItem, "name");
 
 		if (vlItemName != NULL && cJSON_IsString(vlItemName) && strcmp(vlItemName->valuestring, input) == 0) {
-			if(getVLItemFromRoot(vlItem, item)==1)return 1;
+			int error = getVLItemFromRoot(vlItem, item);
+			cJSON_Delete(vlItemRoot);
+			return error;
 		}
 	}
-
+	cJSON_Delete(vlItemRoot);
 	return 0;
 }
 
@@ -572,18 +575,63 @@ int getVLItembyNr(VLItem *item,int i){
 		return 1;
 	}
 	if(getJsonRoot(&vlItemRoot, vlItemFile)==1)return 1;
-	closeFileStream(vlItemFile,0);
 	cJSON *vlitems = cJSON_GetObjectItem(vlItemRoot, "ItemData");
 	if(vlitems == NULL){
 		fprintf(stderr,"Error ItemData in vlItems.json not found\n");
+		cJSON_Delete(vlItemRoot);
 		return 1;
 	}
 	cJSON *vlItem = cJSON_GetArrayItem(vlitems, i);
-	//NEED TO TEST
-	if(getVLItemFromRoot(vlItem, item)==1){
+	if(vlItem == NULL || getVLItemFromRoot(vlItem, item)==1){
 		fprintf(stderr,"Item %d couldn't be extracted from vlItem.json\n",i);
+		cJSON_Delete(vlItemRoot);
 		return 1;
 	}
+	cJSON_Delete(vlItemRoot);
+	return 0;
+}
+
+/**
+ * @brief Retrieve all VLItems from the JSON file.
+ *
+ * This function parses vlItem.json once and populates the given array with all VLItems found in it.
+ *
+ * @param items    Array of VLItem structures to be populated.
+ * @param maxCount Capacity of the array.
+ * @param count    Number of VLItems written to the array.
+ * @return         Returns 0 on success, 1 if an error occurs.
+ */
+int getVLItemsFromJson(VLItem *items, int maxCount, int *count){
+	cJSON *vlItemRoot = NULL;
+	FILE *vlItemFile = NULL;
+	*count = 0;
+	if(createFileStream(&vlItemFile, "vlItem.json", "r",0)==1){
+		fprintf(stderr,"Error vlItems.json couldn't be opened\n");
+		return 1;
+	}
+	if(getJsonRoot(&vlItemRoot, vlItemFile)==1)return 1;
+	cJSON *vlitems = cJSON_GetObjectItem(vlItemRoot, "ItemData");
+	if(vlitems == NULL){
+		fprintf(stderr,"Error ItemData in vlItems.json not found\n");
+		cJSON_Delete(vlItemRoot);
+		return 1;
+	}
+	int size = cJSON_GetArraySize(vlitems);
+	if(size > maxCount){
+		fprintf(stderr,"vlItem.json holds %d items, only %d are loaded\n",size,maxCount);
+		size = maxCount;
+	}
+	cJSON *vlItem = vlitems->child;
+	for(int i = 0; i < size && vlItem != NULL; i++){
+		if(getVLItemFromRoot(vlItem, &items[i])==1){
+			fprintf(stderr,"Item %d couldn't be extracted from vlItem.json\n",i);
+			cJSON_Delete(vlItemRoot);
+			return 1;
+		}
+		(*count)++;
+		vlItem = vlItem->next;
+	}
+	cJSON_Delete(vlItemRoot);
 	return 0;
 }
 
@@ -969,19 +1017,83 @@ void writeItemData(BoardItem *boardItem ,Match *match, CIEntry *entry,FILE *file
 	return;
 }
 
+/**
+ * @brief Converts the value of a CI entry into a number.
+ *
+ * @param val Value string of the CI entry.
+ * @return The value, 1 for "True", 0 for "False" or NAN if the value isn't a number.
+ */
+static double parseCIValue(const char *val){
+	char *endptr;
+	if (strcmp(val, "True") == 0) {
+		return 1;
+	} else if (strcmp(val, "False") == 0) {
+		return 0;
+	}
+	float floatResult = strtof(val, &endptr);
+	if (*endptr == '\0' && endptr != val){
+		return floatResult;
+	}
+	return NAN;
+}
+
+/**
+ * @brief Fills a VLItem with the item data written to vlItem.json.
+ *
+ * Same content as writeItemData, but stored directly in a VLItem, so the catalog can be created without
+ * parsing vlItem.json again. The bit items are copied into a new allocation owned by the VLItem.
+ *
+ * @param item Pointer to the VLItem to fill.
+ * @param boardItem Pointer to the BoardItem structure containing the board item details.
+ * @param match Pointer to the Match structure containing the match details. Can be NULL if no match is available.
+ * @param entry Pointer to the CIEntry structure containing the entry details. Can be NULL if no entry is available.
+ * @return Returns 0 on success, 1 if the memory allocation for the bit items failed.
+ */
+int fillVLItem(VLItem *item, BoardItem *boardItem, Match *match, CIEntry *entry){
+	memset(item, 0, sizeof(VLItem));
+	snprintf(item->name, sizeof(item->name), "%s", boardItem->name);
+	if(match != NULL){
+		snprintf(item->CIField, sizeof(item->CIField), "%s", match->CIField);
+		snprintf(item->CIKey, sizeof(item->CIKey), "%s", match->CIKey);
+	}
+	memcpy(item->Address, boardItem->Address, sizeof(item->Address));
+	memcpy(item->LenTyp, boardItem->LenTyp, sizeof(item->LenTyp));
+	memcpy(item->Flags, boardItem->Flags, sizeof(item->Flags));
+	memcpy(item->Symbol, boardItem->Symbol, sizeof(item->Symbol));
+	memcpy(item->ScaleFactor, boardItem->ScaleFactor, sizeof(item->ScaleFactor));
+	memcpy(item->Unit, boardItem->Unit, sizeof(item->Unit));
+	memcpy(item->MinVal, boardItem->MinVal, sizeof(item->MinVal));
+	memcpy(item->MaxVal, boardItem->MaxVal, sizeof(item->MaxVal));
+	memcpy(item->DefaultValue, boardItem->DefaultValue, sizeof(item->DefaultValue));
+
+	item->BitItems = NULL;
+	item->BitItemCount = 0;
+	if(match != NULL && match->BitItems != NULL && match->bitItemCount > 0){
+		item->BitItems = malloc(match->bitItemCount * sizeof(BitItem));
+		if(item->BitItems == NULL){
+			fprintf(stderr,"Memory allocation for BitItems failed\n");
+			return 1;
+		}
+		memcpy(item->BitItems, match->BitItems, match->bitItemCount * sizeof(BitItem));
+		item->BitItemCount = match->bitItemCount;
+	}
+
+	item->Value = (entry != NULL) ? parseCIValue(entry->Value) : NAN;
+	return 0;
+}
+
 /**
  * @brief Creates a JSON file containing item data.
  *
- * This function reads board item details, match details, and CI entry details from separate JSON files,
- * creates a cJSON object representing the item data for each item, and writes the cJSON objects to a JSON file.
+ * This function combines the board items discovered by getBoardItems with the match details and CI entry details
+ * from separate JSON files and writes the item data of every item to vlItem.json.
  *
+ * @param boardItems The board items read from the board.
  * @param itemcount The number of items for which data will be created.
+ * @param vlItems Array to store the created items as well, e.g. for the catalog. Can be NULL.
  * @return Returns 0 on success, 1 on failure.
  */
-int createDataJson(int itemcount){
-
-	cJSON *boardItemRoot = NULL;
-	FILE *boardItemFile = NULL;
+int createDataJson(BoardItem *boardItems, int itemcount, VLItem *vlItems){
 
 	cJSON *matchRoot = NULL;
 	FILE *matchFile = NULL;
@@ -993,26 +1105,16 @@ int createDataJson(int itemcount){
 	cJSON *itemOutput = cJSON_CreateObject();
 	FILE *itemFile = NULL;
 
-	createFileStream(&boardItemFile, "boardItems.json", "r",0);
-	if(getJsonRoot(&boardItemRoot, boardItemFile)==1){
-		fprintf(stderr,"Error finding JSON root in boarditems.json\n");
-		return 1;
-	}
-	closeFileStream(boardItemFile,0);
-
-	createFileStream(&matchFile, "match.json", "r",0);
-	if(getJsonRoot(&matchRoot, matchFile)==1){
+	// getJsonRoot closes the file streams itself
+	if(createFileStream(&matchFile, "match.json", "r",0)==1 || getJsonRoot(&matchRoot, matchFile)==1){
 		fprintf(stderr,"Error finding JSON root in match.json\n");
 		return 1;
 	}
-	closeFileStream(matchFile,0);
 
-	createFileStream(&CIEntryFile, "CI-Servo.json", "r",0);
-	if(getJsonRoot(&CIEntryRoot, CIEntryFile)==1){
+	if(createFileStream(&CIEntryFile, "CI-Servo.json", "r",0)==1 || getJsonRoot(&CIEntryRoot, CIEntryFile)==1){
 		fprintf(stderr,"Error finding JSON root in CI-Servo.json\n");
 		return 1;
 	}
-	closeFileStream(CIEntryFile,0);
 
 	if(createFileStream(&itemFile, "vlItem.json", "w",0)==1){
 		fprintf(stderr,"Error vlItems.json couldn't be opened\n");
@@ -1022,21 +1124,9 @@ int createDataJson(int itemcount){
 	BoardItem *boardItem = NULL;
 	Match *match = NULL;
 	CIEntry *cientry = NULL;
-	VLItem *itemdata = NULL;
-
-	itemdata = (VLItem *)malloc(sizeof(VLItem));
-
-	if(itemdata == NULL){
-		fprintf(stderr,"Memory allocation for itemdata failed\n");
-		return 1;
-	}
 
 	for(int i = 0;i<itemcount;i++){
-		boardItem = getBoardItemByNr(boardItemRoot,i);
-		if(boardItem == NULL){
-			fprintf(stderr,"Board Item with number %d not found\n",i);
-			return 1;
-		}
+		boardItem = &boardItems[i];
 		match = getMatchByItemName(matchRoot,boardItem->name);
 		if(match != NULL){
 			if(match->BitItems != NULL){
@@ -1064,13 +1154,19 @@ int createDataJson(int itemcount){
 					}else{
 						match->BitItems[j].value = -1;
 					}
+					free(cientry);
 				}
 			}
 			cientry = getCIEntryByFieldAndKey(CIEntryRoot, match->CIField, match->CIKey);
 		}
 		writeItemData(boardItem, match, cientry, itemFile, itemArray);
+		if(vlItems != NULL && fillVLItem(&vlItems[i], boardItem, match, cientry)==1){
+			return 1;
+		}
+		// the entry belongs to this item only, items without match must not inherit it
+		free(cientry);
+		cientry = NULL;
 		fflush(stdout);
-		free(boardItem);
 		if(match != NULL){
 			free(match->BitItems);
 			free(match);
@@ -1080,8 +1176,8 @@ int createDataJson(int itemcount){
 	char *itemString = cJSON_Print(itemOutput);
 	fprintf(itemFile, "%s\n", itemString);
 	closeFileStream(itemFile,0);
-	cJSON_Delete(itemArray);
-	cJSON_Delete(boardItemRoot);
+	free(itemString);
+	cJSON_Delete(itemOutput);
 	cJSON_Delete(matchRoot);
 	cJSON_Delete(CIEntryRoot);
 
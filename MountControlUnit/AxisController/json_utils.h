@@ -86,6 +86,7 @@ BoardItem* getBoardItemFromJson(char *itemName);
 
 int getVLItemFromJson(VLItem *itemdata,char *input);
 int getVLItembyNr(VLItem *item,int i);
+int getVLItemsFromJson(VLItem *items, int maxCount, int *count);
 
 void createJsonArray(cJSON *json, char *data, int size, char *name);
 
@@ -96,7 +97,8 @@ int createJson(cJSON *objArray);
 int setvlistJsonFile();
 
 void error_handler(char* error);
-int createDataJson(int itemcount);
+int createDataJson(BoardItem *boardItems, int itemcount, VLItem *vlItems);
+int fillVLItem(VLItem *item, BoardItem *boardItem, Match *match, CIEntry *entry);
 
 
 
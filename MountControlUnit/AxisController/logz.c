@@ -3,31 +3,76 @@
  *
  *  Created on: 19.01.2024
  *      Author: morit
+ *
+ * logz only copies the message into a ring buffer of the calling thread, every thread has its own single
+ * producer, single consumer ring. A background writer thread drains the rings, formats the timestamps and
+ * writes the records to the log file, so the control loops never wait for the disk.
+ * The ring of a thread is released when the thread exits and taken over by the next new thread, the rings
+ * are freed once the last user closes the logger.
  */
 
 #include "logz.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
 #include <time.h>
 #include <stddef.h>
-#include <windows.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "common_utils.h"
+#include "thread_utils.h"
+
+typedef struct
+{
+	time_t timestamp;
+	uint16_t length;
+	char text[LOG_MESSAGE_SIZE];
+} LogRecord;
+
+typedef struct
+{
+	LogRecord records[LOG_RING_SIZE];
+	atomic_uint head;		// next record written by the producer thread
+	atomic_uint tail;		// next record read by the writer thread
+	atomic_uint dropped;	// records lost because the ring was full
+	atomic_int inUse;		// 1 while a thread owns the ring, released by releaseThreadRing
+} LogRing;
 
 static FILE *logFile;
-static int initDone = 0;
+static atomic_int initDone;
+static int userCount = 0;	// threads which called initLogger, the last closeLogger closes the file
 char fileName[100];
 
-static char* get_datetime() {
-    time_t t = time(NULL);
-    struct tm *tm  = localtime(&t);
-    const char *d_time = asctime(tm);
-    const char *datetime = strchr(d_time, '\n');
-    int length = datetime - d_time;
-
-    char *date = malloc(length + 1);
-    strncpy(date, d_time, length);
-    date[length] = '\0';
-    return date;
+static LogRing *rings[LOG_MAX_THREADS];
+static atomic_int ringCount;
+static pthread_mutex_t ringLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t writerThread;
+static atomic_int writerRunning;
+static atomic_uint generation;				// incremented whenever the rings are freed
+static pthread_key_t ringKey;				// releases the ring of a thread on its exit
+static pthread_once_t ringKeyOnce = PTHREAD_ONCE_INIT;
+static __thread LogRing *threadRing;
+static __thread unsigned int threadGeneration;
+
+// timestamp of the last written record, formatted once per second only
+static time_t cachedTime = -1;
+static char cachedDate[32];
+
+static const char* get_datetime(time_t t) {
+    if (t != cachedTime) {
+        struct tm *tm = localtime(&t);
+        const char *d_time = asctime(tm);
+        size_t length = strcspn(d_time, "\n");
+        if (length >= sizeof(cachedDate)) {
+            length = sizeof(cachedDate) - 1;
+        }
+        memcpy(cachedDate, d_time, length);
+        cachedDate[length] = '\0';
+        cachedTime = t;
+    }
+    return cachedDate;
 }
 
 void getDateTimeString(char *buffer) {
@@ -51,8 +96,97 @@ static void convertWindowsPathToPOSIX(char *path) {
     }
 }
 
+// Destructor of ringKey, hands the ring of an exiting thread back. Records not written yet stay in the ring and
+// are written by the writer thread as usual, even after another thread took the ring over.
+static void releaseThreadRing(void *ring) {
+    pthread_mutex_lock(&ringLock);
+    // rings of an earlier logger were freed by closeLogger
+    if (threadGeneration == atomic_load(&generation)) {
+        atomic_store(&((LogRing*)ring)->inUse, 0);
+    }
+    pthread_mutex_unlock(&ringLock);
+}
+
+static void createRingKey() {
+    pthread_key_create(&ringKey, releaseThreadRing);
+}
+
+// Returns the ring of the calling thread. On the first message of the thread a released ring is taken over,
+// a new one is created only if all rings are in use.
+static LogRing* getThreadRing() {
+    if (threadRing != NULL && threadGeneration == atomic_load(&generation)) {
+        return threadRing;
+    }
+    pthread_mutex_lock(&ringLock);
+    threadRing = NULL;
+    int count = atomic_load(&ringCount);
+    for (int i = 0; i < count && threadRing == NULL; i++) {
+        if (atomic_load(&rings[i]->inUse) == 0) {
+            threadRing = rings[i];
+        }
+    }
+    if (threadRing == NULL && count < LOG_MAX_THREADS) {
+        threadRing = calloc(1, sizeof(LogRing));
+        if (threadRing != NULL) {
+            rings[count] = threadRing;
+            atomic_store(&ringCount, count + 1);
+        }
+    }
+    if (threadRing != NULL) {
+        atomic_store(&threadRing->inUse, 1);
+        threadGeneration = atomic_load(&generation);
+        pthread_setspecific(ringKey, threadRing);
+    }
+    pthread_mutex_unlock(&ringLock);
+    return threadRing;
+}
+
+// Writes all records of all rings to the log file, returns the number of written records
+static int drainRings() {
+    int written = 0;
+    int count = atomic_load(&ringCount);
+    for (int i = 0; i < count; i++) {
+        LogRing *ring = rings[i];
+        unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        while (tail != head) {
+            LogRecord *record = &ring->records[tail % LOG_RING_SIZE];
+            fprintf(logFile, "%s, %.*s\n", get_datetime(record->timestamp), (int)record->length, record->text);
+            tail++;
+            written++;
+        }
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+        unsigned int dropped = atomic_exchange(&ring->dropped, 0);
+        if (dropped > 0) {
+            fprintf(logFile, "%s, %u log messages dropped, log ring full\n", get_datetime(time(NULL)), dropped);
+        }
+    }
+    if (written > 0) {
+        fflush(logFile);
+    }
+    return written;
+}
+
+static void* logWriter(void *arg) {
+    (void) arg;
+    while (atomic_load(&writerRunning)) {
+        if (drainRings() == 0) {
+            sleep_ms(LOG_WRITER_INTERVAL_MS);
+        }
+    }
+    drainRings();
+    return NULL;
+}
+
 void initLogger(char *fileNm){
 	char path[100];
+	pthread_mutex_lock(&ringLock);
+	userCount++;
+	if(atomic_load(&initDone) == 1){
+		pthread_mutex_unlock(&ringLock);
+		return;
+	}
 	strcpy(path,DEFAULT_LOG_PATH);
 	convertWindowsPathToPOSIX(path);
 	strcpy(fileName,path);
@@ -65,31 +199,69 @@ void initLogger(char *fileNm){
 	}else{
 		strcat(fileName,DEFAULT_LOG_FILENAME);
 	}
-	if (GetFileAttributes(DEFAULT_LOG_PATH) == INVALID_FILE_ATTRIBUTES) {
-		CreateDirectory(DEFAULT_LOG_PATH, NULL);
-	}
+	pthread_once(&ringKeyOnce, createRingKey);
+	createDirectory(path);
 	logFile = fopen(fileName,"w");
 	if(logFile == NULL){
 		fprintf(stderr,"LOGFILE couldn't be created");
+		pthread_mutex_unlock(&ringLock);
+		return;
+	}
+	atomic_store(&writerRunning, 1);
+	// the writer does disk I/O, it must not run with the priority and on the core of the axle calling initLogger
+	if(startHelperThread(&writerThread, logWriter, NULL, 0) != 0){
+		fprintf(stderr,"Log writer thread couldn't be started");
+		fclose(logFile);
+		pthread_mutex_unlock(&ringLock);
 		return;
 	}
-	initDone = 1;
+	atomic_store(&initDone, 1);
+	pthread_mutex_unlock(&ringLock);
 }
 
 void logz(char *message){
-	if(initDone == 0){
+	if(atomic_load(&initDone) == 0){
 		fprintf(stderr,"Inizialise Logger first. (initLogger(char *logFileName)");
 		return;
 	}
-	char *date = get_datetime();
-	fprintf(logFile,"%s, %s\n",date,message);
-	fflush(logFile);
-	free(date);
+	LogRing *ring = getThreadRing();
+	if(ring == NULL){
+		return;
+	}
+	unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+	if(head - tail >= LOG_RING_SIZE){
+		atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+		return;
+	}
+	LogRecord *record = &ring->records[head % LOG_RING_SIZE];
+	size_t length = strlen(message);
+	if(length > LOG_MESSAGE_SIZE){
+		length = LOG_MESSAGE_SIZE;
+	}
+	record->timestamp = time(NULL);
+	record->length = length;
+	memcpy(record->text, message, length);
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
 }
 
 void closeLogger(){
-	if(initDone == 1){
+	pthread_mutex_lock(&ringLock);
+	if(userCount > 0){
+		userCount--;
+	}
+	if(atomic_load(&initDone) == 1 && userCount == 0){
+		atomic_store(&initDone, 0);
+		atomic_store(&writerRunning, 0);
+		pthread_join(writerThread, NULL);
 		fclose(logFile);
+		int count = atomic_load(&ringCount);
+		for(int i = 0; i < count; i++){
+			free(rings[i]);
+			rings[i] = NULL;
+		}
+		atomic_store(&ringCount, 0);
+		atomic_fetch_add(&generation, 1);
 	}
+	pthread_mutex_unlock(&ringLock);
 }
-
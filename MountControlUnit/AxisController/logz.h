@@ -11,6 +11,11 @@
 #define DEFAULT_LOG_PATH ".\\logs"
 #define DEFAULT_LOG_FILENAME "log"
 
+#define LOG_MESSAGE_SIZE 240		// longer messages are truncated
+#define LOG_RING_SIZE 256			// records per thread, messages are dropped while the ring is full
+#define LOG_MAX_THREADS 16
+#define LOG_WRITER_INTERVAL_MS 5	// idle time of the writer thread between two empty polls
+
 void initLogger(char *fileName);
 void logz(char *logMessage);
 void closeLogger();
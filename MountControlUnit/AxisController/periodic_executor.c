@@ -0,0 +1,123 @@
+/**
+ * @file periodic_executor.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Fixed rate executor of control loop cycles
+ *
+ * @details The cycles are released on an absolute time grid, the n-th cycle is released at start + n * period.
+ *	Reading from the board, logging and the sleep itself therefore shift single cycles, but never the grid.
+ *	Every cycle records its start delay behind the release time (jitter) and its run time. A cycle finishing
+ *	after the release of the next one is an overrun, the releases which already passed are skipped and counted as
+ *	missed deadlines, so the loop keeps its phase instead of running late cycles back to back.
+ *	The statistics are kept in the histograms of comm_stats.c and can be read or dumped at any time from the
+ *	thread running the executor.
+ **/
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "periodic_executor.h"
+#include "timing_utils.h"
+
+
+/**
+ * @brief Initialises an executor, the cycles are not started until runPeriodicExecutor is called
+ * @param executor Executor to initialise
+ * @param name Name of the loop in the statistics
+ * @param period Period of the cycles in ns
+ * @param callback Called once per cycle with userData
+ * @param userData State of the loop
+ */
+void initPeriodicExecutor(PeriodicExecutor *executor, const char *name, uint64_t period, CycleCallback callback,
+		void *userData){
+	memset(&executor->stats, 0, sizeof(executor->stats));
+	executor->name = name;
+	executor->period = period;
+	executor->callback = callback;
+	executor->userData = userData;
+	executor->release = 0;
+	atomic_store(&executor->stopRequested, 0);
+}
+
+
+/**
+ * Runs the cycles until the callback returns a value other than 0 or stopPeriodicExecutor is called. The first
+ * cycle is released immediately.
+ *
+ * @param executor Initialised executor
+ * @return Value returned by the last cycle, 0 if the executor was stopped
+ */
+int runPeriodicExecutor(PeriodicExecutor *executor){
+	PeriodicStats *stats = &executor->stats;
+	int result = 0;
+
+	executor->release = monotonicNs();
+	while(atomic_load_explicit(&executor->stopRequested, memory_order_relaxed) == 0){
+		sleepUntilNs(executor->release);
+		uint64_t start = monotonicNs();
+		recordLatency(&stats->jitter, start - executor->release);
+
+		result = executor->callback(executor->userData);
+
+		uint64_t end = monotonicNs();
+		recordLatency(&stats->execution, end - start);
+		stats->cycles++;
+		if(result != 0){
+			break;
+		}
+
+		executor->release += executor->period;
+		if(end > executor->release){
+			uint64_t skipped = (end - executor->release) / executor->period + 1;
+			stats->overruns++;
+			stats->missedDeadlines += skipped;
+			executor->release += skipped * executor->period;
+		}
+	}
+	return result;
+}
+
+
+/**
+ * @brief Stops the executor after the running cycle, may be called from any thread
+ * @param executor Running executor
+ */
+void stopPeriodicExecutor(PeriodicExecutor *executor){
+	atomic_store(&executor->stopRequested, 1);
+}
+
+
+void getPeriodicStats(PeriodicExecutor *executor, PeriodicStats *stats){
+	memcpy(stats, &executor->stats, sizeof(PeriodicStats));
+}
+
+
+/**
+ * @brief Writes the cycle counters and the jitter and run time percentiles in us
+ * @param executor Executor to report
+ * @param stream Destination, e.g. stdout
+ */
+void dumpPeriodicStats(PeriodicExecutor *executor, FILE *stream){
+	PeriodicStats *stats = &executor->stats;
+	LatencyHistogram *histograms[] = { &stats->jitter, &stats->execution };
+	const char *names[] = { "jitter", "execution" };
+
+	fprintf(stream, "Periodic loop %s: %" PRIu64 " cycles of %.1f us, %" PRIu64 " overruns, %" PRIu64
+			" missed deadlines\n", executor->name, stats->cycles, executor->period / 1000.0, stats->overruns,
+			stats->missedDeadlines);
+	fprintf(stream, "%-12s %10s %10s %10s %10s %10s %10s %10s\n",
+			"", "min", "mean", "p50", "p90", "p99", "p99.9", "max");
+	for(int i = 0; i < 2; i++){
+		LatencyHistogram *histogram = histograms[i];
+		if(histogram->count == 0){
+			continue;
+		}
+		fprintf(stream, "%-12s %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+				names[i], histogram->min / 1000.0, (double)histogram->sum / histogram->count / 1000.0,
+				getLatencyPercentile(histogram, 50.0) / 1000.0, getLatencyPercentile(histogram, 90.0) / 1000.0,
+				getLatencyPercentile(histogram, 99.0) / 1000.0, getLatencyPercentile(histogram, 99.9) / 1000.0,
+				histogram->max / 1000.0);
+	}
+	fflush(stream);
+}
@@ -0,0 +1,61 @@
+/*
+ * periodic_executor.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef PERIODIC_EXECUTOR_H_
+#define PERIODIC_EXECUTOR_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+// the executors of the MountController are owned by C++ code, which has no <stdatomic.h> before C++23
+#ifdef __cplusplus
+#include <atomic>
+using std::atomic_int;
+extern "C" {
+#else
+#include <stdatomic.h>
+#endif
+
+#include "comm_stats.h"
+
+#define MOTION_LOOP_PERIOD_NS 10000000ULL	// period of the trajectory loops, 100 Hz
+
+// Called once per period, returns 0 to continue and any other value to stop the executor
+typedef int (*CycleCallback)(void *userData);
+
+typedef struct
+{
+	uint64_t cycles;
+	uint64_t overruns;			// cycles which did not finish before the release of the next cycle
+	uint64_t missedDeadlines;	// releases skipped after overruns, late cycles are never run back to back
+	LatencyHistogram jitter;	// delay of the cycle start behind its release time in ns
+	LatencyHistogram execution;	// run time of the callback in ns
+} PeriodicStats;
+
+typedef struct
+{
+	const char *name;
+	uint64_t period;			// in ns
+	CycleCallback callback;
+	void *userData;
+	uint64_t release;			// release time of the current cycle on the clock of monotonicNs
+	atomic_int stopRequested;
+	PeriodicStats stats;
+} PeriodicExecutor;
+
+void initPeriodicExecutor(PeriodicExecutor *executor, const char *name, uint64_t period, CycleCallback callback,
+		void *userData);
+int runPeriodicExecutor(PeriodicExecutor *executor);
+void stopPeriodicExecutor(PeriodicExecutor *executor);
+void getPeriodicStats(PeriodicExecutor *executor, PeriodicStats *stats);
+void dumpPeriodicStats(PeriodicExecutor *executor, FILE *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERIODIC_EXECUTOR_H_ */
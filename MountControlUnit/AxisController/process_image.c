@@ -0,0 +1,190 @@
+/**
+ * @file process_image.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Cyclic snapshot of subscribed board items
+ *
+ * @details Control loops reading their items from the board wait a full round trip every cycle, so the loop rate
+ *	is bound to the network. A process image reads all subscribed items in one pipelined burst per period from
+ *	its own poller thread instead, and the loops take the latest snapshot without any I/O.
+ *	The poller reads into a back buffer while holding the lock of the connection, the loop can still write to the
+ *	board in between. The complete refresh is then copied to the older of two front buffers and published by
+ *	incrementing the sequence, which selects the newest one. A reader copies the newest front buffer, which the
+ *	poller doesn't touch until the next refresh is published. Only if a refresh was published during the copy, the
+ *	copy is repeated, at most PROCESS_IMAGE_READ_ATTEMPTS times. Readers never wait for the poller, even if it was
+ *	preempted in the middle of a copy, and the poller never waits for them.
+ **/
+
+#include <string.h>
+
+#include "process_image.h"
+#include "timing_utils.h"
+#include "transport.h"
+#include "thread_utils.h"
+#include "logz.h"
+
+
+/**
+ * @brief Copies the back buffer to the older front buffer and publishes it as the newest one
+ * @param image Process image
+ */
+static void publishSnapshot(ProcessImage *image){
+	unsigned int next = atomic_load_explicit(&image->sequence, memory_order_relaxed) + 1;
+	// the buffer was the newest one until the last publish, readers still copying it see the sequence changed
+	atomic_thread_fence(memory_order_release);
+	memcpy(&image->front[next & 1], &image->back, sizeof(ProcessImageSnapshot));
+	atomic_store_explicit(&image->sequence, next, memory_order_release);
+}
+
+
+static int refreshCycle(void *userData){
+	ProcessImage *image = userData;
+
+	lockBoardConnection(image->connection);
+	readItemMany(image->connection, image->handles, image->back.values, image->back.status, image->count);
+	unlockBoardConnection(image->connection);
+	image->back.refreshes++;
+	image->back.timestamp = monotonicNs();
+	publishSnapshot(image);
+	if(image->onRefresh != NULL){
+		image->onRefresh(&image->back, image->refreshUserData);
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Initialises an empty process image
+ * @param image Process image to initialise
+ * @param connection Connection the items are read from, shared with the thread reading the process image
+ * @param period Refresh period in ns
+ */
+void initProcessImage(ProcessImage *image, BoardConnection *connection, uint64_t period){
+	memset(image->handles, 0, sizeof(image->handles));
+	memset(&image->back, 0, sizeof(image->back));
+	memset(image->front, 0, sizeof(image->front));
+	image->connection = connection;
+	image->count = 0;
+	image->running = 0;
+	image->onRefresh = NULL;
+	image->refreshUserData = NULL;
+	atomic_store(&image->sequence, 0);
+	initPeriodicExecutor(&image->executor, "process image", period, refreshCycle, image);
+}
+
+
+/**
+ * Adds an item or bit item in dot-notation to the process image. Items are subscribed before the process image
+ * is started, their values are found at the returned index in every snapshot.
+ *
+ * @param image Process image, not started yet
+ * @param name Item name, optionally followed by '.' and a bit item name
+ * @param index Pointer to store the position of the item in the snapshots
+ * @return 0 on success, 1 if the item doesn't exist, the process image is full or already started
+ */
+int subscribeItem(ProcessImage *image, const char *name, int *index){
+	if(image->running || image->count == PROCESS_IMAGE_ITEMS){
+		sprintf(image->connection->message,"Process image: Item (%s) couldn't be subscribed.",name);
+		logz(image->connection->message);
+		return 1;
+	}
+	if(resolveItem(image->connection, name, &image->handles[image->count]) == 1){
+		return 1;
+	}
+	image->back.status[image->count] = 1;
+	*index = (int) image->count++;
+	return 0;
+}
+
+
+/**
+ * @brief Sets the function called by the poller after every refresh, before the process image is started
+ * @param image Process image
+ * @param callback Function to call with the new snapshot, NULL to remove it
+ * @param userData Passed to the callback
+ */
+void setRefreshCallback(ProcessImage *image, RefreshCallback callback, void *userData){
+	image->onRefresh = callback;
+	image->refreshUserData = userData;
+}
+
+
+static void* pollerThread(void *argument){
+	ProcessImage *image = argument;
+	runPeriodicExecutor(&image->executor);
+	transportRelease();
+	return NULL;
+}
+
+
+/**
+ * Starts the poller thread. It runs with HELPER_THREAD_PRIORITY on the cores not used by the calling thread, so
+ * the control loop of its axle never preempts it, or without real time priority like the calling thread. From now on every thread using
+ * the connection has to hold its lock, see lockBoardConnection.
+ *
+ * @param image Process image with all items subscribed
+ * @return 0 on success, 1 otherwise
+ */
+int startProcessImage(ProcessImage *image){
+	if(image->running){
+		return 1;
+	}
+	initPeriodicExecutor(&image->executor, "process image", image->executor.period, refreshCycle, image);
+	if(startHelperThread(&image->thread, pollerThread, image, HELPER_THREAD_PRIORITY) != 0){
+		logz("Process image: Starting the poller thread failed.");
+		return 1;
+	}
+	image->running = 1;
+	return 0;
+}
+
+
+/**
+ * @brief Stops the poller thread and waits for it, the last snapshot stays readable
+ * @param image Process image
+ */
+void stopProcessImage(ProcessImage *image){
+	if(!image->running){
+		return;
+	}
+	stopPeriodicExecutor(&image->executor);
+	pthread_join(image->thread, NULL);
+	image->running = 0;
+}
+
+
+/**
+ * @brief Stops the process image and releases the handles of the subscribed items
+ * @param image Process image
+ */
+void releaseProcessImage(ProcessImage *image){
+	stopProcessImage(image);
+	for(size_t i = 0; i < image->count; i++){
+		releaseItem(image->handles[i]);
+		image->handles[i] = NULL;
+	}
+	image->count = 0;
+}
+
+
+/**
+ * Copies the latest complete refresh. Never blocks, does no I/O and never waits for the poller: the copy is only
+ * repeated if the poller published new refreshes while it was taken, at most PROCESS_IMAGE_READ_ATTEMPTS times.
+ *
+ * @param image Process image
+ * @param snapshot Pointer to store the snapshot, its content is undefined if 1 is returned
+ * @return 0 on success, 1 if the process image wasn't refreshed yet or every copy overlapped with a publish
+ */
+int readProcessImage(ProcessImage *image, ProcessImageSnapshot *snapshot){
+	for(int attempt = 0; attempt < PROCESS_IMAGE_READ_ATTEMPTS; attempt++){
+		unsigned int begin = atomic_load_explicit(&image->sequence, memory_order_acquire);
+		memcpy(snapshot, &image->front[begin & 1], sizeof(ProcessImageSnapshot));
+		atomic_thread_fence(memory_order_acquire);
+		unsigned int end = atomic_load_explicit(&image->sequence, memory_order_relaxed);
+		if(begin == end){
+			return snapshot->refreshes == 0;
+		}
+	}
+	return 1;
+}
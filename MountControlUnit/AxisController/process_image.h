@@ -0,0 +1,70 @@
+/*
+ * process_image.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef PROCESS_IMAGE_H_
+#define PROCESS_IMAGE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "periodic_executor.h"
+
+// process images are owned by the C++ axes as well, which have no <stdatomic.h> before C++23
+#ifdef __cplusplus
+#include <atomic>
+using std::atomic_uint;
+extern "C" {
+#else
+#include <stdatomic.h>
+#endif
+
+#include "board_connection.h"
+#include "item_handle.h"
+
+#define PROCESS_IMAGE_ITEMS 32
+#define PROCESS_IMAGE_PERIOD_NS 5000000ULL	// refresh period of the motion loops, twice the loop rate
+#define PROCESS_IMAGE_READ_ATTEMPTS 3		// copies readProcessImage tries before it gives up, see there
+
+typedef struct
+{
+	uint32_t values[PROCESS_IMAGE_ITEMS];	// values as returned by readItem, kept from the last good read on failure
+	int status[PROCESS_IMAGE_ITEMS];		// 0 if the value was read by the refresh, 1 otherwise
+	uint64_t refreshes;						// number of the refresh, 0 before the first one
+	uint64_t timestamp;						// monotonicNs at the end of the refresh
+} ProcessImageSnapshot;
+
+// Called by the poller after every published refresh, e.g. to detect changes of the values
+typedef void (*RefreshCallback)(const ProcessImageSnapshot *snapshot, void *userData);
+
+typedef struct
+{
+	BoardConnection *connection;
+	ItemHandle *handles[PROCESS_IMAGE_ITEMS];
+	size_t count;
+	ProcessImageSnapshot back;		// filled by the poller while it reads the board
+	ProcessImageSnapshot front[2];	// last two complete refreshes, the newest one is front[sequence & 1]
+	atomic_uint sequence;			// number of published refreshes
+	RefreshCallback onRefresh;		// NULL if not needed
+	void *refreshUserData;
+	PeriodicExecutor executor;
+	pthread_t thread;
+	int running;
+} ProcessImage;
+
+void initProcessImage(ProcessImage *image, BoardConnection *connection, uint64_t period);
+int subscribeItem(ProcessImage *image, const char *name, int *index);
+void setRefreshCallback(ProcessImage *image, RefreshCallback callback, void *userData);
+int startProcessImage(ProcessImage *image);
+void stopProcessImage(ProcessImage *image);
+void releaseProcessImage(ProcessImage *image);
+int readProcessImage(ProcessImage *image, ProcessImageSnapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROCESS_IMAGE_H_ */
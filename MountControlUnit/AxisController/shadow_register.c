@@ -0,0 +1,114 @@
+/**
+ * @file shadow_register.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Client side copy of the item data of the board
+ *
+ * @details Bit items share one item word on the board. Writing a bit item merges the new bits into the current
+ *	word, which used to be read from the board before every write and doubled the round trips of every bit write.
+ *	Every connection keeps the last word it read from or wrote to each item. A bit write merges into that shadow
+ *	word and costs a single write, and a write leaving the word unchanged is not sent at all.
+ *	The board itself changes some bits, e.g. it clears the run bits on an error. A shadow word is therefore only
+ *	trusted for resyncPeriod after it was read or written, older words are read from the board again. Items with
+ *	bits the board sets or clears on its own, like the self clearing reset bit of sysid_control or the run bits in
+ *	state_1 and state_2, which the board clears on a fault, bypass the shadow completely: a stale bit would
+ *	otherwise be written back or a needed write be suppressed. Their bit writes always merge into the word read
+ *	from the board right before. Failed writes and reloading the VLItems drop the shadow words.
+ **/
+
+#include <string.h>
+
+#include "shadow_register.h"
+#include "timing_utils.h"
+
+
+/**
+ * @brief Initialises a register file without known words, resyncing after SHADOW_RESYNC_PERIOD_NS
+ * @param file Register file to initialise
+ */
+void initShadowRegisters(ShadowRegisterFile *file){
+	invalidateShadowRegisters(file);
+	file->resyncPeriod = SHADOW_RESYNC_PERIOD_NS;
+	file->suppressRedundant = 1;
+}
+
+
+/**
+ * @brief Forgets all words and bypasses, e.g. after the VLItems were loaded again and the indices changed
+ * @param file Register file
+ */
+void invalidateShadowRegisters(ShadowRegisterFile *file){
+	memset(file->registers, 0, sizeof(file->registers));
+}
+
+
+/**
+ * @brief Sets how long a word is trusted after it was read or written
+ * @param file Register file
+ * @param resyncPeriod Period in ns, SHADOW_NO_RESYNC or SHADOW_DISABLED
+ */
+void setShadowResyncPeriod(ShadowRegisterFile *file, uint64_t resyncPeriod){
+	file->resyncPeriod = resyncPeriod;
+}
+
+
+/**
+ * @brief Gets the word of an item, if it was read or written within the resync period
+ * @param file Register file
+ * @param index Position of the item in the VLItem cache
+ * @param word Pointer to store the word
+ * @return 0 if the word is valid, 1 if it has to be read from the board
+ */
+int getShadowRegister(ShadowRegisterFile *file, int index, uint32_t *word){
+	if(index < 0 || index >= MAXSIZE || file->resyncPeriod == SHADOW_DISABLED){
+		return 1;
+	}
+	ShadowRegister *shadow = &file->registers[index];
+	if(shadow->bypass || shadow->syncedAt == 0 || monotonicNs() - shadow->syncedAt > file->resyncPeriod){
+		return 1;
+	}
+	*word = shadow->word;
+	return 0;
+}
+
+
+/**
+ * @brief Stores the word of an item after it was read from or written to the board
+ * @param file Register file
+ * @param index Position of the item in the VLItem cache, ignored if negative
+ * @param word Item data of the board
+ */
+void setShadowRegister(ShadowRegisterFile *file, int index, uint32_t word){
+	if(index < 0 || index >= MAXSIZE){
+		return;
+	}
+	file->registers[index].word = word;
+	file->registers[index].syncedAt = monotonicNs();
+}
+
+
+/**
+ * @brief Forgets the word of an item, e.g. after a failed write left the board state unknown
+ * @param file Register file
+ * @param index Position of the item in the VLItem cache, ignored if negative
+ */
+void invalidateShadowRegister(ShadowRegisterFile *file, int index){
+	if(index < 0 || index >= MAXSIZE){
+		return;
+	}
+	file->registers[index].syncedAt = 0;
+}
+
+
+/**
+ * @brief Excludes an item the board changes by itself from the shadow, until the registers are invalidated
+ * @param file Register file
+ * @param index Position of the item in the VLItem cache, ignored if negative
+ */
+void bypassShadowRegister(ShadowRegisterFile *file, int index){
+	if(index < 0 || index >= MAXSIZE){
+		return;
+	}
+	file->registers[index].bypass = 1;
+}
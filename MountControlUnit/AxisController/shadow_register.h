@@ -0,0 +1,40 @@
+/*
+ * shadow_register.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef SHADOW_REGISTER_H_
+#define SHADOW_REGISTER_H_
+
+#include <stdint.h>
+#include "vlitem_handler.h"
+
+#define SHADOW_RESYNC_PERIOD_NS 100000000ULL	// age after which a shadow word is read from the board again
+#define SHADOW_NO_RESYNC UINT64_MAX				// shadow words never expire
+#define SHADOW_DISABLED 0						// every bit write reads the board first
+
+typedef struct
+{
+	uint32_t word;			// item data last read from or written to the board
+	uint64_t syncedAt;		// monotonic time of the last read or write in ns, 0 if the word is unknown
+	int bypass;				// the board changes the item by itself, the word is always read from the board
+} ShadowRegister;
+
+typedef struct
+{
+	ShadowRegister registers[MAXSIZE];	// indexed like the items of the VLItem cache
+	uint64_t resyncPeriod;				// SHADOW_RESYNC_PERIOD_NS, SHADOW_NO_RESYNC or SHADOW_DISABLED
+	int suppressRedundant;				// bit writes leaving a valid word unchanged are not sent
+} ShadowRegisterFile;
+
+void initShadowRegisters(ShadowRegisterFile *file);
+void invalidateShadowRegisters(ShadowRegisterFile *file);
+void setShadowResyncPeriod(ShadowRegisterFile *file, uint64_t resyncPeriod);
+int getShadowRegister(ShadowRegisterFile *file, int index, uint32_t *word);
+void setShadowRegister(ShadowRegisterFile *file, int index, uint32_t word);
+void invalidateShadowRegister(ShadowRegisterFile *file, int index);
+void bypassShadowRegister(ShadowRegisterFile *file, int index);
+
+#endif /* SHADOW_REGISTER_H_ */
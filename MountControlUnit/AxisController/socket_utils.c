@@ -10,11 +10,8 @@
  *	further guarantee
  **/
 
-#include <winsock2.h>
-#include <windows.h>
-#include <ws2tcpip.h>
 #include <stdio.h>
-#include <conio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include "cJSON.h"
@@ -22,62 +19,213 @@
 #include <stdint.h>
 
 #include "json_utils.h"
+#include "socket_utils.h"
+#include "comm_pipeline.h"
+#include "board_trace.h"
+#include "comm_stats.h"
 #include "vlitem_handler.h"
 #include "sockets.h"
+#include "transport.h"
 #include "logz.h"
 #include "common_utils.h"
 
 
-#define DEFAULT_BUFLEN 128
+/**
+ * @brief Initialises an unconnected board connection with an empty item cache
+ * @param connection Connection to initialise
+ */
+void initBoardConnection(BoardConnection *connection){
+	memset(connection, 0, sizeof(BoardConnection));
+	connection->socket = INVALID_SOCKET;
+	initVlItemCache(&connection->items);
+	initShadowRegisters(&connection->shadows);
+	pthread_mutex_init(&connection->lock, NULL);
+}
+
+
+/**
+ * @brief Closes the socket and unmaps the item catalog and the trace of a connection
+ * @param connection Connection to close
+ */
+void closeBoardConnection(BoardConnection *connection){
+	if(connection->socket != INVALID_SOCKET){
+		transportClose(connection->socket);
+		connection->socket = INVALID_SOCKET;
+	}
+	closeVlItemCatalog(&connection->catalog);
+	initVlItemCache(&connection->items);
+	invalidateShadowRegisters(&connection->shadows);
+	closeBoardTrace(&connection->trace);
+}
+
+
+/**
+ * @brief Gives the calling thread exclusive use of a connection shared with other threads
+ *
+ * Only needed while more than one thread uses the connection, e.g. while a process image polls it. The buffers,
+ * the item cache, the shadow words and the statistics of the connection are all protected by the lock.
+ *
+ * @param connection Connection to lock
+ */
+void lockBoardConnection(BoardConnection *connection){
+	pthread_mutex_lock(&connection->lock);
+}
+
 
 /**
- * @brief Buffer for sending data to the ASA board
+ * @brief Releases a connection locked with lockBoardConnection
+ * @param connection Connection to unlock
  */
-unsigned char sendData[16] ={ 0 };
+void unlockBoardConnection(BoardConnection *connection){
+	pthread_mutex_unlock(&connection->lock);
+}
+
 
 /**
- * @brief Buffer for receiving data from ASA board
+ * @brief Fills the VLItem cache with all items of the catalog
+ *
+ * The catalog vlItem.bin is mapped, if it is up to date. Otherwise vlItem.json is parsed once and the catalog
+ * is rebuilt first, it keeps the fingerprint of the catalog it replaces. Needs to be called after vlItem.json was
+ * created.
+ *
+ * @param connection	Connection to the board the items belong to
+ * @return	0 if successful 1 otherwise
  */
-char recieved_data[DEFAULT_BUFLEN] = {0};
+int loadVLItems(BoardConnection *connection){
+	BoardFingerprint fingerprint = { 0 };
+	closeVlItemCatalog(&connection->catalog);
+	int outdated = isVlItemCatalogOutdated(VLITEM_CATALOG_FILE, "vlItem.json");
+	if(openVlItemCatalog(&connection->catalog, VLITEM_CATALOG_FILE)==1 || outdated==1){
+		// vlItem.json was created for the same board and configuration, openBoardCatalog still has to match it
+		if(connection->catalog.header != NULL){
+			fingerprint = connection->catalog.header->fingerprint;
+			closeVlItemCatalog(&connection->catalog);
+		}
+		logz("VLItem catalog is outdated, rebuilding it from vlItem.json");
+		if(createVlItemCatalogFromJson(VLITEM_CATALOG_FILE, &fingerprint)==1
+				|| openVlItemCatalog(&connection->catalog, VLITEM_CATALOG_FILE)==1){
+			logz("Creating the VLItem catalog from vlItem.json failed");
+			return 1;
+		}
+	}
+	loadVlItemCache(&connection->items, &connection->catalog);
+	invalidateShadowRegisters(&connection->shadows);
+	sprintf(connection->message,"%d VLItems loaded into the VLItem cache",connection->items.count);
+	logz(connection->message);
+	return 0;
+}
+
 
 /**
- * @brief Cache buffer for previously accessed VLItems.
+ * @brief Loads the VLItems from the catalog, if it was created for the connected board and configuration
+ *
+ * Used on start to skip the board item discovery when nothing changed since the last run.
  *
- * This buffer is designed to optimize I/O operations by caching VLItems that have already been
- * read from the vlItem.json file. When a VLItem is fetched from vlItem.json, it is stored in this buffer.
- * Subsequent accesses to the same VLItem will utilize this cache, significantly reducing the need
- * for repetitive reads from the file, thereby enhancing performance and efficiency.
+ * @param connection	Connection to the board
+ * @param fingerprint	Fingerprint of the connected board and the current configuration
+ * @return	0 if the catalog matches and was loaded, 1 if the board items have to be discovered
  */
-VLItem items[MAXSIZE];
+int openBoardCatalog(BoardConnection *connection, BoardFingerprint *fingerprint){
+	closeVlItemCatalog(&connection->catalog);
+	if(openVlItemCatalog(&connection->catalog, VLITEM_CATALOG_FILE)==1){
+		return 1;
+	}
+	if(!matchesVlItemCatalog(&connection->catalog, fingerprint)){
+		closeVlItemCatalog(&connection->catalog);
+		return 1;
+	}
+	loadVlItemCache(&connection->items, &connection->catalog);
+	invalidateShadowRegisters(&connection->shadows);
+	sprintf(connection->message,"Board unchanged, %d VLItems loaded from the VLItem catalog",connection->items.count);
+	logz(connection->message);
+	return 0;
+}
+
 
 /**
- * @brief String for log message. Used with the 'logz' logging libary
+ * @brief Creates the catalog for the connected board and loads the VLItems from it
+ *
+ * @param connection	Connection to the board
+ * @param fingerprint	Fingerprint of the connected board and the configuration the items were created from
+ * @param vlItems	Items created by createDataJson
+ * @param count	Number of items
+ * @return	0 if successful 1 otherwise
  */
-char message[DEFAULT_BUFLEN*10];
+int createBoardCatalog(BoardConnection *connection, BoardFingerprint *fingerprint, VLItem *vlItems, int count){
+	closeVlItemCatalog(&connection->catalog);
+	if(writeVlItemCatalog(vlItems, count, fingerprint, VLITEM_CATALOG_FILE)==1
+			|| openVlItemCatalog(&connection->catalog, VLITEM_CATALOG_FILE)==1){
+		logz("Creating the VLItem catalog failed");
+		return 1;
+	}
+	loadVlItemCache(&connection->items, &connection->catalog);
+	invalidateShadowRegisters(&connection->shadows);
+	sprintf(connection->message,"%d VLItems loaded into the VLItem cache",connection->items.count);
+	logz(connection->message);
+	return 0;
+}
+
 
 /**
  * @brief Retrieves VLItem from buffer
  *
- * Searches cache for item, if not found searches in json file (IO Operation)
+ * Searches the cache for the item. The cache is filled from the catalog on first use, if loadVLItems wasn't called.
  *
- * @param item	Requested item
+ * @param connection	Connection to the board the item belongs to
+ * @param item	Pointer to the requested item, stays valid until the items are loaded again
  * @param item_name	Name of requested item
  * @return	0 if successful 1 otherwise
  */
-int getVLItem(VLItem *item,char*item_name){
-	VLItem *itemPtr = getVlItemFromArray(item_name, items);
-	if (itemPtr == NULL) {
-		if(getVLItemFromJson(item, item_name)==1)return 1;
-		if(0!=strcmp(item->name,item_name)){
-			fprintf(stderr,"Item with the name : (%s) not found (%s)",item_name,item->name);
-			fflush(stderr);
-			return 1;
-		}else{
-			addVlItemToArray(*item, items);
-		}
-	} else {
-		memcpy(item,itemPtr,sizeof(VLItem));
+int getVLItem(BoardConnection *connection, VLItem **item, char *item_name){
+	if(connection->catalog.base == NULL && loadVLItems(connection)==1){
+		return 1;
+	}
+	*item = getVlItemFromCache(&connection->items, item_name);
+	if (*item == NULL) {
+		fprintf(stderr,"Item with the name : (%s) not found",item_name);
+		fflush(stderr);
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Retrieves VLItem by its position in vlItem.json
+ *
+ * @param connection	Connection to the board the item belongs to
+ * @param item	Pointer to the requested item, stays valid until the items are loaded again
+ * @param i	Position of the requested item
+ * @return	0 if successful 1 otherwise
+ */
+int getVLItemByNr(BoardConnection *connection, VLItem **item, int i){
+	if(connection->catalog.base == NULL && loadVLItems(connection)==1){
+		return 1;
+	}
+	if(i < 0 || i >= connection->items.count){
+		return 1;
 	}
+	*item = &connection->items.items[i];
+	return 0;
+}
+
+
+/**
+ * @brief Excludes an item, whose bits the board sets or clears by itself, from the shadow words
+ *
+ * Bit writes to the item always read the current word from the board first. Needs to be called again after the
+ * VLItems were loaded.
+ *
+ * @param connection	Connection to the board the item belongs to
+ * @param item_name	Name of the item
+ * @return	0 if successful 1 otherwise
+ */
+int bypassBoardShadow(BoardConnection *connection, char *item_name){
+	VLItem *item;
+	if(getVLItem(connection, &item, item_name)==1){
+		return 1;
+	}
+	bypassShadowRegister(&connection->shadows, getVlItemIndex(&connection->items, item));
 	return 0;
 }
 
@@ -121,29 +269,28 @@ int encode(unsigned char *data, unsigned char *function)
 
 /**
  * @brief Creates and configures socket and connects to ASA Board
- * @param clientSocket	Created socket
+ * @param connection	Connection to the board, holds the created socket afterwards
  * @important this code is WINDOWS specific
  * @return 0 if succeeded 1 otherwise
  */
-int createConnection(SOCKET *clientSocket,char *ip_Address, int port){
+int createConnection(BoardConnection *connection, char *ip_Address, int port){
 	printf("StartUp!\n");
 	fflush(stdout);
-	WSADATA wsaData;
-	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+	if (socketsStartup() != 0)
 	{
-		sprintf(message,"Connection to Board failed. Error: Failed to initialize Winsock. IP-Address : %s, Port, %d.",ip_Address,port);
-		logz(message);
+		sprintf(connection->message,"Connection to Board failed. Error: Failed to initialize Winsock. IP-Address : %s, Port, %d.",ip_Address,port);
+		logz(connection->message);
 		printf("Failed to initialize Winsock.\n");
 		return 1;
 	}
 
-	*clientSocket = socket(AF_INET, SOCK_STREAM, 0);
-	if (*clientSocket == INVALID_SOCKET)
+	connection->socket = socket(AF_INET, SOCK_STREAM, 0);
+	if (connection->socket == INVALID_SOCKET)
 	{
-		sprintf(message,"Connection to Board failed. Error: Failed to create socket. ERRORCODE: %d. IP-Address : %s, Port, %d.",WSAGetLastError(),ip_Address,port);
-		logz(message);
-		printf("Failed to create socket. Error code: %d\n", WSAGetLastError());
-		WSACleanup();
+		sprintf(connection->message,"Connection to Board failed. Error: Failed to create socket. ERRORCODE: %d. IP-Address : %s, Port, %d.",getError(),ip_Address,port);
+		logz(connection->message);
+		printf("Failed to create socket. Error code: %d\n", getError());
+		socketsShutdown();
 		return 1;
 	}
 	struct sockaddr_in serverAddress;
@@ -151,30 +298,30 @@ int createConnection(SOCKET *clientSocket,char *ip_Address, int port){
 	serverAddress.sin_port = htons(port);
 	if (inet_pton(AF_INET, ip_Address, &(serverAddress.sin_addr)) <= 0)
 	{
-		sprintf(message,"Connection to Board failed. Error: Invalid address or address not supported. IP-Address : %s, Port, %d.",ip_Address,port);
-		logz(message);
+		sprintf(connection->message,"Connection to Board failed. Error: Invalid address or address not supported. IP-Address : %s, Port, %d.",ip_Address,port);
+		logz(connection->message);
 		printf("Invalid address or address not supported.\n");
-		closesocket(*clientSocket);
-		WSACleanup();
+		closesocket(connection->socket);
+		socketsShutdown();
 		return 1;
 	}
 
-	if (connect(*clientSocket, (struct sockaddr*) &serverAddress,
-			sizeof(serverAddress)) < 0)
+	if (transportConnect(connection->socket, &serverAddress) != 0)
 	{
-		sprintf(message,"Connection to Board failed. Error: Failed to connect to the server. ERRORCODE: %d. IP-Address : %s, Port, %d.",WSAGetLastError(),ip_Address,port);
-		logz(message);
+		int error = getError();
+		sprintf(connection->message,"Connection to Board failed. Error: Failed to connect to the server. ERRORCODE: %d. IP-Address : %s, Port, %d.",error,ip_Address,port);
+		logz(connection->message);
 		printf("Failed to connect to the server. Error code: %d\n",
-				WSAGetLastError());
-		closesocket(*clientSocket);
-		WSACleanup();
+				error);
+		transportClose(connection->socket);
+		socketsShutdown();
 		return 1;
 	}
 	else
 	{
 
-		sprintf(message,"Connection to Board established. IP-Address : %s, Port, %d.",ip_Address,port);
-		logz(message);
+		sprintf(connection->message,"Connection to Board established. IP-Address : %s, Port, %d.",ip_Address,port);
+		logz(connection->message);
 		printf("Connected\n");
 	}
 	fflush(stdout);
@@ -185,60 +332,86 @@ int createConnection(SOCKET *clientSocket,char *ip_Address, int port){
 /**
  * Receives and validates data from a TCP socket. It reads the expected amount of data plus overhead,
  * checks for connection issues, and performs a CRC check on the received data.
- * If any error occurs or CRC check fails, it logs the error, cleans up, and exits.
+ * If the connection fails, the error is logged and returned, the process keeps running, so the other axles and
+ * the caller can still react to it. With the POSIX backend a board not answering within TRANSPORT_TIMEOUT_MS is
+ * such an error.
  *
- * @param socket TCP socket for the connection.
+ * @param connection Connection to read from.
  * @param receivedDataBuffer Buffer for the received data.
  * @param expectedBytes Number of expected data bytes, excluding protocol overhead.
- * @return 0 on success, 1 on CRC error.
+ * @return 0 on success, 1 on CRC error, 2 if the connection failed.
  */
-int recv_dataf(SOCKET socket, char *receivedDataBuffer, int expectedBytes)
+int recv_dataf(BoardConnection *connection, char *receivedDataBuffer, int expectedBytes)
 {
 	int bytesRead = 0;
 	int byteSum = 0;
-	int totalBytes;
-	int packages = expectedBytes/14;
-	if(expectedBytes%14==0){
-		totalBytes = expectedBytes + (packages * 2);
-	}else{
-		totalBytes = expectedBytes + ((packages+1) * 2);
-	}
-
+	// a write is only acknowledged by the echoed function code and the checksum
+	int totalBytes = expectedBytes > 0 ? replyFrameSize(expectedBytes) : ACK_FRAME_SIZE;
 
 	do
 	{
-		bytesRead = recv(socket, receivedDataBuffer + byteSum, DEFAULT_BUFLEN,
-				0);
+		bytesRead = transportRecv(connection->socket, receivedDataBuffer + byteSum, totalBytes - byteSum);
 
 		if (bytesRead > 0)
 		{
 			byteSum += bytesRead;
+			countBytesReceived(&connection->stats, bytesRead);
 		}
 		else if (bytesRead == 0)
 		{
 			logz("Board Read Operation failed: Connection closed by the server.");
 			printf("Connection closed by the server.\n");
 			fflush(stdout);
-			closesocket(socket);
-			WSACleanup();
-			printf("Close Socket!!!");
-			exit(EXIT_FAILURE);
+			return 2;
 		}
 		else
 		{
-			sprintf(message,"Board Read Operation failed: Failed to receive data from the server. Error code: %d\n",
-					WSAGetLastError());
-			logz(message);
+			int error = getError();
+			sprintf(connection->message,"Board Read Operation failed: Failed to receive data from the server. Error code: %d\n",
+					error);
+			logz(connection->message);
 			printf("Failed to receive data from the server. Error code: %d\n",
-					WSAGetLastError());
+					error);
 			fflush(stdout);
-			closesocket(socket);
-			WSACleanup();
-			exit(EXIT_FAILURE);
+			return 2;
 		}
 	} while (byteSum < totalBytes);
 
-	//CRC Check
+	if(checkReplyChecksum(receivedDataBuffer, totalBytes) == 1){
+		countCrcError(&connection->stats);
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * Calculates the number of bytes the board sends for a reply carrying `expectedBytes` of payload.
+ * Every package of up to 14 payload bytes is framed by two bytes of protocol overhead.
+ *
+ * @param expectedBytes Number of expected data bytes, excluding protocol overhead.
+ * @return Total number of bytes of the reply on the wire.
+ */
+int replyFrameSize(int expectedBytes)
+{
+	int packages = expectedBytes/14;
+	if(expectedBytes%14==0){
+		return expectedBytes + (packages * 2);
+	}
+	return expectedBytes + ((packages+1) * 2);
+}
+
+
+/**
+ * Performs the CRC check on a received reply. The bytes of every 16 byte package have to sum up to zero
+ * (modulo 256).
+ *
+ * @param receivedDataBuffer Buffer holding the complete reply.
+ * @param totalBytes Number of bytes of the reply including protocol overhead.
+ * @return 0 if the checksum is valid, 1 on CRC error.
+ */
+int checkReplyChecksum(char *receivedDataBuffer, int totalBytes)
+{
 	int i=0;
 	int numBytes;
 	int leftBytes = totalBytes;
@@ -268,42 +441,61 @@ int recv_dataf(SOCKET socket, char *receivedDataBuffer, int expectedBytes)
  * Handles sending and receiving data to/from a control board via TCP. It sends a command/data to the board and expects a response.
  * The function ensures all bytes are sent and received correctly, performing retries if necessary. It incorporates error handling
  * for both sending and receiving phases, including a CRC check through `recv_dataf`.
+ * Every transaction is counted in the communication statistics (comm_stats.c) with its round trip time.
  *
- * @param clientSocket The socket used for communication with the control board.
+ * @param connection The connection used for communication with the control board.
  * @param bytesToSend Buffer containing bytes to send to the board.
  * @param bytesToReceive Buffer to store bytes received from the board.
  * @param bytesToSendSize Number of bytes to send.
  * @param bytesToReceiveSize Expected number of bytes to receive.
- * @return Returns 0 on successful communication, 1 on failure after retries.
+ * @return Returns 0 on successful communication, 1 on failure after retries or at once if the connection failed.
  */
-int controlBoardCommWR(SOCKET clientSocket, unsigned char *bytesToSend,char *bytesToReceive, size_t bytesToSendSize, size_t bytesToReceiveSize){
-	size_t totalBytesSend = 0;
-	size_t bytesSend = 0;
-
+int controlBoardCommWR(BoardConnection *connection, unsigned char *bytesToSend,char *bytesToReceive, size_t bytesToSendSize, size_t bytesToReceiveSize){
 	int inc = 0;
 	int error;
+	uint64_t start = monotonicNs();
 	do{
-		 error = 0;
+		error = 0;
+		size_t totalBytesSend = 0;
 		while(bytesToSendSize > totalBytesSend){
-			bytesSend += send(clientSocket,(char*) bytesToSend, bytesToSendSize, 0);
-			if(bytesSend ==-1){
+			int bytesSend = transportSend(connection->socket,(char*) &bytesToSend[totalBytesSend], bytesToSendSize - totalBytesSend);
+			if(bytesSend <= 0){
 				logz("Board Communication failed. ERROR: Send failed");
 				error+=1;
+				break;
 			}
 			totalBytesSend += bytesSend;
 		}
-		error += recv_dataf(clientSocket,(char*) bytesToReceive, bytesToReceiveSize);
-
-		if(bytesToSend[1] != bytesToReceive[0]){
-			error += 1;
+		countBytesSent(&connection->stats, totalBytesSend);
+		if(error == 0){
+			int received = recv_dataf(connection,(char*) bytesToReceive, bytesToReceiveSize);
+			if(received == 2){
+				// a reply arriving late would be taken for the reply of a retry, the stream is out of sync
+				countCommTransaction(&connection->stats, bytesToSend[1], 0, 1);
+				traceBoardTransaction(&connection->trace, bytesToSend, NULL, start, monotonicNs(), inc, 1);
+				return 1;
+			}
+			error += received;
+			if(bytesToSend[1] != bytesToReceive[0]){
+				countFunctionError(&connection->stats);
+				error += 1;
+			}
 		}
-		inc += error;
-		if(inc == 3){
-			Sleep(100);
-			logz("Board GetBoardItems Operation: Data transmission failed (CRC Error)");
-			return 1;
+		if(error >= 1){
+			inc++;
+			if(inc == 3){
+				countCommTransaction(&connection->stats, bytesToSend[1], 0, 1);
+				traceBoardTransaction(&connection->trace, bytesToSend, NULL, start, monotonicNs(), inc, 1);
+				sleep_ms(100);
+				logz("Board GetBoardItems Operation: Data transmission failed (CRC Error)");
+				return 1;
+			}
+			countRetry(&connection->stats);
 		}
 	}while(error >= 1);
+	uint64_t end = monotonicNs();
+	countCommTransaction(&connection->stats, bytesToSend[1], end - start, 0);
+	traceBoardTransaction(&connection->trace, bytesToSend, bytesToReceive, start, end, inc, 0);
 	return 0;
 }
 
@@ -361,12 +553,12 @@ int extractInformationFromData(char *recievedData, int expectedBytes)
  * Reads data from a board by sending a read command for a specified item. It constructs a command using the item's address
  * and length type, sends it, and processes the received data.
  *
- * @param clientSocket Socket used for communication with the board.
+ * @param connection Connection used for communication with the board.
  * @param item_name Name of the item to read from the board.
  * @param data Buffer to store the read data.
  * @return 0 on success, 1 on failure to read or if the item is not found.
  */
-int readFromBoard(SOCKET clientSocket, char *item_name, char *data)
+int readFromBoard(BoardConnection *connection, char *item_name, char *data)
 {
 	unsigned char readRam[] =
 	{ 5, 4, 0, 0, 0, 0 };
@@ -374,72 +566,203 @@ int readFromBoard(SOCKET clientSocket, char *item_name, char *data)
 	{ 0 };
 
 	char receivedDataBuffer[DEFAULT_BUFLEN];
-	VLItem item;
-	if(getVLItem(&item,item_name)==1){
+	VLItem *item;
+	if(getVLItem(connection, &item, item_name)==1){
 		return 1;
 	}
 
-	memcpy(&readRam[2], item.Address, sizeof(item.Address));
-	size_t size	 =	lenTypToByte(item.LenTyp[0]);
+	memcpy(&readRam[2], item->Address, sizeof(item->Address));
+	size_t size	 =	lenTypToByte(item->LenTyp[0]);
 	readRam[5] = size;
 	encode(sendData, readRam);
 
-	if(controlBoardCommWR(clientSocket,sendData,receivedDataBuffer,16,size)==1){
+	if(controlBoardCommWR(connection,sendData,receivedDataBuffer,16,size)==1){
 		return 1;
 	}
 	memcpy(data,&(receivedDataBuffer[1]),4);
+	uint32_t word;
+	if(charArrayToUint32(data, size, &word) == 0){
+		setShadowRegister(&connection->shadows, getVlItemIndex(&connection->items, item), word);
+	}
 	return 0;
 }
 
 
 /**
- * Reads numerical data from a board for a given item and converts it to a uint32_t value.
+ * Splits an item name in dot-notation (e.g., "item.field") into the VLItem name and the BitItem name.
+ * Both output buffers have to hold at least 35 characters, the size of the name fields in VLItem and BitItem.
  *
- * @param clientSocket Socket for communication with the board.
- * @param item_name Name of the item to read.
- * @param num Pointer to store the converted numerical value.
- * @param size Size of the data to read and convert.
- * @return 0 on successful read and conversion, 1 on failure.
+ * @param input Item name, optionally followed by '.' and a bit item name.
+ * @param itemName Buffer for the VLItem name.
+ * @param bitName Buffer for the BitItem name, set to an empty string if the input has no bit item.
+ * @return 0 on success, 1 if one of the names is too long.
  */
-int readFromBoardNumber(SOCKET clientSocket, char *item_name, uint32_t *num, size_t size){
-	char data[4] ={0,0,0,0};
+int splitItemName(const char *input, char *itemName, char *bitName){
+	size_t maxLength = sizeof(((VLItem*)0)->name);
+	const char *dot = strchr(input, '.');
+	size_t itemLength = (dot == NULL) ? strlen(input) : (size_t)(dot - input);
 
-	readFromBoard(clientSocket, item_name, data);
-	if(charArrayToUint32(data, size, num))return 1;
+	if(itemLength >= maxLength || (dot != NULL && strlen(dot + 1) >= maxLength)){
+		fprintf(stderr,"Item name (%s) is too long",input);
+		fflush(stderr);
+		return 1;
+	}
+	memcpy(itemName, input, itemLength);
+	itemName[itemLength] = '\0';
+	if(dot != NULL){
+		strcpy(bitName, dot + 1);
+	}else{
+		bitName[0] = '\0';
+	}
 	return 0;
 }
 
 
+/**
+ * Converts the raw bytes of a read reply into a typed value according to the item's length type.
+ * For bit items the bit field is extracted instead and stored as unsigned value.
+ *
+ * @param read Read to store the value in.
+ * @param raw Raw item data as received from the board.
+ * @param bitItem BitItem to extract, NULL for plain items.
+ */
+static void decodeBoardRead(BoardRead *read, uint32_t raw, BitItem *bitItem){
+	if(bitItem != NULL){
+		uint32_t bitmask = (1u << bitItem->size) - 1;
+		read->value.u32 = (raw >> bitItem->startBit) & bitmask;
+		return;
+	}
+	switch(read->lenTyp){
+	case 8:
+		read->value.i16 = (int16_t) raw;
+		break;
+	case 9:
+		read->value.u16 = (uint16_t) raw;
+		break;
+	case 10:
+		read->value.i32 = (int32_t) raw;
+		break;
+	case 12:
+		memcpy(&read->value.f, &raw, sizeof(float));
+		break;
+	default:
+		read->value.u32 = raw;
+		break;
+	}
+}
+
+
+/**
+ * Reads several items from the board in one pipelined burst. All read RAM frames (function 4) are encoded first,
+ * sent with a single send call and the replies are decoded into the typed values of `reads`.
+ * Items can be plain items or bit items in dot-notation (e.g., "item.field"). Names and data types are
+ * validated before any frame is sent; items failing validation are skipped and marked as failed.
+ *
+ * @param connection Connection for communication with the board.
+ * @param reads Items to read. `name` and `expectedLenTyp` are inputs, the remaining fields are filled in.
+ * @param count Number of items to read.
+ * @return 0 if all items were read successfully, 1 if at least one read failed.
+ */
+int readFromBoardMany(BoardConnection *connection, BoardRead *reads, size_t count){
+	CommPipeline pipeline;
+	CommRequest requests[PIPELINE_DEPTH];
+	BitItem *bitItems[PIPELINE_DEPTH];
+	VLItem *items[PIPELINE_DEPTH];
+	int error = 0;
+
+	pipelineInit(&pipeline, connection);
+	for(size_t chunk = 0; chunk < count; chunk += PIPELINE_DEPTH){
+		size_t chunkSize = count - chunk;
+		if(chunkSize > PIPELINE_DEPTH){
+			chunkSize = PIPELINE_DEPTH;
+		}
+
+		for(size_t i = 0; i < chunkSize; i++){
+			BoardRead *read = &reads[chunk + i];
+			char itemName[sizeof(((VLItem*)0)->name)];
+			char bitName[sizeof(((BitItem*)0)->bitName)];
+			VLItem *item;
+
+			read->status = 1;
+			read->isBitItem = 0;
+			bitItems[i] = NULL;
+			requests[i].status = 1;
+			if(splitItemName(read->name, itemName, bitName) == 1 || getVLItem(connection, &item, itemName) == 1){
+				error = 1;
+				continue;
+			}
+			read->lenTyp = item->LenTyp[0];
+			items[i] = item;
+			if(bitName[0] != '\0'){
+				if(item->BitItemCount <= 0 || getBitItemFromVlItem(item, bitName, &bitItems[i]) == 1){
+					sprintf(connection->message,"Board Read Operation: failed. Error: BitItem (%s) not found in Item (%s).",bitName,itemName);
+					logz(connection->message);
+					error = 1;
+					continue;
+				}
+				read->isBitItem = 1;
+			}else if(read->expectedLenTyp != 0 && read->lenTyp != read->expectedLenTyp){
+				fprintf(stderr,"Wrong data type. Item %s need data type %d.",itemName,read->lenTyp);
+				sprintf(connection->message,"Board Read Operation: failed. Error: Wrong data type. Item %s need data type %d.",itemName,read->lenTyp);
+				logz(connection->message);
+				fflush(stderr);
+				error = 1;
+				continue;
+			}
+
+			unsigned char readRam[] = { 5, 4, 0, 0, 0, 0 };
+			memcpy(&readRam[2], item->Address, sizeof(item->Address));
+			readRam[5] = lenTypToByte(item->LenTyp[0]);
+			if(pipelinePrepare(&requests[i], readRam, readRam[5], NULL, NULL) == 1){
+				error = 1;
+				continue;
+			}
+			pipelineSubmit(&pipeline, &requests[i]);
+		}
+
+		if(pipelineFlush(&pipeline) == 1){
+			error = 1;
+		}
+
+		for(size_t i = 0; i < chunkSize; i++){
+			BoardRead *read = &reads[chunk + i];
+			uint32_t raw;
+			if(requests[i].status != 0){
+				continue;
+			}
+			if(charArrayToUint32(&requests[i].reply[1], lenTypToByte(read->lenTyp), &raw) == 1){
+				error = 1;
+				continue;
+			}
+			setShadowRegister(&connection->shadows, getVlItemIndex(&connection->items, items[i]), raw);
+			decodeBoardRead(read, raw, bitItems[i]);
+			read->status = 0;
+		}
+	}
+	return error;
+}
+
+
 /**
  * Reads a float value from a board for a specified item. Validates the item's data type before reading,
  * ensuring it matches the expected float type code. Logs detailed error messages if the data type does not match.
  *
- * @param clientSocket Socket for communication with the board.
+ * @param connection Connection for communication with the board.
  * @param item_name Name of the item to read.
  * @param num Pointer to store the read float value.
  * @return 0 on successful read and conversion, 1 on failure or data type mismatch.
  */
-int readFromBoardFloat(SOCKET clientSocket, char *item_name, float *num){
-	VLItem item;
-
-	if(getVLItem(&item,item_name)==1){
-		return 1;
-	}
-	if(item.LenTyp[0]!=12){
-		fprintf(stderr,"Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		sprintf(message,"Board Read Operation: failed. Error: Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		logz(message);
-		fflush(stderr);
-		return 1;
-	}
-	uint32_t tempNum;
-	if (readFromBoardNumber(clientSocket, item_name, &tempNum, 4) == 1) {
+int readFromBoardFloat(BoardConnection *connection, char *item_name, float *num){
+	BoardRead read = { .name = item_name, .expectedLenTyp = 12 };
+	if(readFromBoardMany(connection, &read, 1) == 1){
 		return 1;
 	}
-	memcpy(num,&tempNum,sizeof(float));
+	*num = read.value.f;
 
-	sprintf(message, "Board Read Operation: Item='%s', Value= %f (Type: float)", item_name, *num);
-	logz(message);
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message, "Board Read Operation: Item='%s', Value= %f (Type: float)", item_name, *num);
+		logz(connection->message);
+	}
 	return 0;
 }
 
@@ -448,32 +771,22 @@ int readFromBoardFloat(SOCKET clientSocket, char *item_name, float *num){
  * Reads an int16 value from a board for a specified item. It checks the item's data type for compatibility
  * before reading, and logs errors if the data type is incorrect.
  *
- * @param clientSocket Socket for board communication.
+ * @param connection Connection for board communication.
  * @param item_name Name of the item to read.
  * @param num Pointer to store the read int16 value.
  * @return 0 on successful read and conversion, 1 on data type mismatch or read failure.
  */
-int readFromBoardInt16(SOCKET clientSocket, char *item_name, int *num){
-	VLItem item;
-	if(getVLItem(&item,item_name)==1){
-		return 1;
-	}
-	if(item.LenTyp[0]!=8){
-		fprintf(stderr,"Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		sprintf(message,"Board Read Operation: failed. Error: Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		logz(message);
-		fflush(stderr);
+int readFromBoardInt16(BoardConnection *connection, char *item_name, int *num){
+	BoardRead read = { .name = item_name, .expectedLenTyp = 8 };
+	if(readFromBoardMany(connection, &read, 1) == 1){
 		return 1;
 	}
-	uint32_t tempNum;
-	if (readFromBoardNumber(clientSocket, item_name, &tempNum, 2) == 1) {
-		return 1;
+	*num = read.value.i16;
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message, "Board Read Operation: Item='%s', Value= %d (Type: int16_t)", item_name, *num);
+		logz(connection->message);
 	}
-	memcpy(num,&tempNum,sizeof(int16_t));
-	sprintf(message, "Board Read Operation: Item='%s', Value= %d (Type: int16_t)", item_name, *num);
-	logz(message);
 	return 0;
-
 }
 
 
@@ -481,31 +794,21 @@ int readFromBoardInt16(SOCKET clientSocket, char *item_name, int *num){
  * Reads a uint16 value from a board for a specified item, ensuring the item's data type matches the expected uint16 type.
  * Errors are logged if the data type is incorrect, providing clear feedback for troubleshooting.
  *
- * @param clientSocket Socket for board communication.
+ * @param connection Connection for board communication.
  * @param item_name Name of the item to read.
  * @param num Pointer to store the read uint16 value.
  * @return 0 on successful read and conversion, 1 on data type mismatch or read failure.
  */
-int readFromBoardUInt16(SOCKET clientSocket, char *item_name, uint16_t *num){
-	VLItem item;
-	if(getVLItem(&item,item_name)==1){
-		return 1;
-	}
-	if(item.LenTyp[0]!=9){
-		fprintf(stderr,"Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		sprintf(message,"Board Read Operation: failed. Error: Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		logz(message);
-		fflush(stderr);
+int readFromBoardUInt16(BoardConnection *connection, char *item_name, uint16_t *num){
+	BoardRead read = { .name = item_name, .expectedLenTyp = 9 };
+	if(readFromBoardMany(connection, &read, 1) == 1){
 		return 1;
 	}
-	uint32_t tempNum;
-	if (readFromBoardNumber(clientSocket, item_name, &tempNum, 2) == 1) {
-		return 1;
+	*num = read.value.u16;
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message, "Board Read Operation: Item='%s', Value= %u (Type: uint16_t)", item_name, *num);
+		logz(connection->message);
 	}
-
-	memcpy(num,&tempNum,sizeof(uint16_t));
-	sprintf(message, "Board Read Operation: Item='%s', Value= %u (Type: uint16_t)", item_name, *num);
-	logz(message);
 	return 0;
 }
 
@@ -514,32 +817,22 @@ int readFromBoardUInt16(SOCKET clientSocket, char *item_name, uint16_t *num){
  * Reads an int32 value from a board for a specified item, verifying the item's data type is correctly an int32.
  * If the data type does not match, an error is logged, and the function fails, providing feedback for diagnosis.
  *
- * @param clientSocket Socket for communication with the board.
+ * @param connection Connection for communication with the board.
  * @param item_name Name of the item to read.
  * @param num Pointer to store the read int32 value.
  * @return 0 on success, indicating the value was read and matches the expected data type; 1 on failure, due to type mismatch or other read errors.
  */
-int readFromBoardInt32(SOCKET clientSocket, char *item_name, int32_t *num) {
-    VLItem item;
-    if (getVLItem(&item, item_name) == 1) {
-        return 1;
-    }
-    if (item.LenTyp[0] != 10) {
-        fprintf(stderr, "Wrong data type. Item %s needs data type %d.\n", item_name, item.LenTyp[0]);
-		sprintf(message,"Board Read Operation: failed. Error: Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		logz(message);
-		fflush(stderr);
-        return 1;
-    }
-    uint32_t tempNum;
-    if (readFromBoardNumber(clientSocket, item_name, &tempNum, 4) == 1) {
-        return 1;
-    }
-    memcpy(num,&tempNum,sizeof(int32_t));
-
-    sprintf(message, "Board Read Operation: Item='%s', Value= %d (Type: int32_t)", item_name, *num);
-	logz(message);
-    return 0;
+int readFromBoardInt32(BoardConnection *connection, char *item_name, int32_t *num) {
+	BoardRead read = { .name = item_name, .expectedLenTyp = 10 };
+	if(readFromBoardMany(connection, &read, 1) == 1){
+		return 1;
+	}
+	*num = read.value.i32;
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message, "Board Read Operation: Item='%s', Value= %d (Type: int32_t)", item_name, *num);
+		logz(connection->message);
+	}
+	return 0;
 }
 
 
@@ -547,94 +840,49 @@ int readFromBoardInt32(SOCKET clientSocket, char *item_name, int32_t *num) {
  * Reads a uint32 value from a board for a specified item, checking the item's data type to ensure it is a uint32.
  * If the data type is incorrect, it logs an error and fails, ensuring data integrity and correct operation handling.
  *
- * @param clientSocket Socket for board communication.
+ * @param connection Connection for board communication.
  * @param item_name Name of the item to be read.
  * @param num Pointer to store the read uint32 value.
  * @return 0 on successful data read and conversion, 1 on data type mismatch or conversion error.
  */
-int readFromBoardUInt32(SOCKET clientSocket, char *item_name, uint32_t *num){
-	VLItem item;
-	char data[4] ={0,0,0,0};
-	if(getVLItem(&item,item_name)==1){
-
+int readFromBoardUInt32(BoardConnection *connection, char *item_name, uint32_t *num){
+	BoardRead read = { .name = item_name, .expectedLenTyp = 11 };
+	if(readFromBoardMany(connection, &read, 1) == 1){
 		return 1;
 	}
-	if(item.LenTyp[0]!=11){
-		fprintf(stderr,"Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		sprintf(message,"Board Read Operation: failed. Error: Wrong data type. Item %s need data type %d.",item_name,item.LenTyp[0]);
-		fflush(stderr);
-		logz(message);
-		return 1;
+	*num = read.value.u32;
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message, "Board Read Operation: Item='%s', Value= %u (Type: uint32_t)", item_name, *num);
+		logz(connection->message);
 	}
-
-	readFromBoard(clientSocket, item_name, data);
-
-	if(charArrayToUint32(data, 4, num)==1)return 1;
-
-	sprintf(message, "Board Read Operation: Item='%s', Value= %u (Type: uint32_t)", item_name, *num);
-	logz(message);
 	return 0;
 }
 
 
 /**
  * Reads a bit field value from a composite board item specified by dot-notation (e.g., "item.field").
- * It parses the item and field names, retrieves the item's full data, and then extracts the designated bit field value.
- * Ensures memory is managed appropriately for dynamic allocations used during parsing.
  *
- * @param clientSocket The communication socket with the board.
+ * @param connection The communication connection with the board.
  * @param input String indicating the item and its bit field.
  * @param data Pointer to store the extracted value.
- * @return 0 if successful, 1 on any failure (e.g., item not found, memory allocation error).
+ * @return 0 if successful, 1 on any failure (e.g., item or bit item not found).
  */
-int readFromBoardBitItem(SOCKET clientSocket, char *input, uint32_t *data){
-	size_t length = strlen(input);
-	char *itemName = malloc(length*sizeof(char));
-	char *bitName = NULL;
-
-	int i;
-	for (i = 0; i < length && input[i] != '.'; i++) {
-		itemName[i] = input[i];
-	}
-
-	itemName[i] = '\0'; // Null-terminate the first part
-
-	if (input[i] == '.') {
-		bitName = malloc(length*sizeof(char));
-		strcpy(bitName, input + i + 1);
-	}
-	if(bitName == NULL){
-		free(bitName);
-		free(itemName);
-	}
-	VLItem item;
-	BitItem *bitItem;
-	uint32_t tempNum;
-	size_t itemSize;
-	char boardData[4] ={0,0,0,0};
-	if(getVLItem(&item,itemName)==1){
+int readFromBoardBitItem(BoardConnection *connection, char *input, uint32_t *data){
+	BoardRead read = { .name = input };
+	if(strchr(input, '.') == NULL){
+		fprintf(stderr,"Provide BitItem like \"itemName.bitName\" instead of (%s)",input);
+		fflush(stderr);
 		return 1;
 	}
-	if(item.BitItemCount<=0){
+	if(readFromBoardMany(connection, &read, 1) == 1){
 		return 1;
 	}
+	*data = read.value.u32;
 
-	if(getBitItemFromVlItem(item, bitName, &bitItem)==1)return 1;
-
-	if(readFromBoard(clientSocket, itemName, boardData)==1)return 1;
-
-	itemSize = lenTypToByte(item.LenTyp[0]);
-
-	if(charArrayToUint32(boardData, itemSize, &tempNum)==1)return 1;
-
-	uint32_t bitmask = (1u << bitItem->size) - 1;
-	*data = (tempNum >> bitItem->startBit)& bitmask;
-
-	sprintf(message, "Board Read Operation: Item='%s', BitItem='%s', Value= %u (Type: bits)", itemName, bitName, *data);
-	logz(message);
-
-	free(bitName);
-	free(itemName);
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message, "Board Read Operation: Item='%s', Value= %u (Type: bits)", input, *data);
+		logz(connection->message);
+	}
 	return 0;
 }
 
@@ -643,46 +891,43 @@ int readFromBoardBitItem(SOCKET clientSocket, char *input, uint32_t *data){
  * Sends data to a specified memory location (item) on a board via RAM write operation. Validates the data size against
  * the expected size derived from the item's length type, constructs a command packet including the item address and data,
  * and communicates with the board using a standard send-receive protocol.
+ * The frame is built on the stack and sent from the buffers of the connection, a write never allocates.
+ * The written data becomes the shadow word of the item, a failed write drops it.
  *
- * @param clientSocket The socket used for communication with the board.
+ * @param connection The connection used for communication with the board.
  * @param dataToSend Pointer to the data to be written to the item's memory location.
  * @param dataAmount Size of the data to send, in bytes.
  * @param item Pointer to the VLItem structure containing item details (name, address, length type).
- * @return 0 on successful write operation, 1 on error (e.g., data size mismatch, memory allocation failure).
+ * @return 0 on successful write operation, 1 on error (e.g., data size mismatch).
  */
-int writeRamF(SOCKET clientSocket, char *dataToSend, int dataAmount, VLItem *item)
+int writeRamF(BoardConnection *connection, char *dataToSend, int dataAmount, VLItem *item)
 {
-
-	unsigned char sendData[16] = { 0 };
-	char *writeRam;
-	char receivedDataBuffer[DEFAULT_BUFLEN];
-
-
+	unsigned char writeRam[FRAME_SIZE] = { 0 };
 	size_t requiredSize = lenTypToByte(item->LenTyp[0]);
 
 	if (dataAmount != requiredSize)
 	{
-		printf("Error: Data sent for %s is not the required size of %I64llu . Instead, got %u.\n",
+		printf("Error: Data sent for %s is not the required size of %zu . Instead, got %d.\n",
 				item->name, requiredSize, dataAmount);
 		return 1;
 
 	}
 
-	// Allocate memory for writeRam
-	writeRam = malloc((4 + requiredSize) * sizeof(char));
-	if (writeRam == NULL)
-	{
-		printf("Error: Memory allocation failed.\n");
-		return 1;
-	}
-
-	memset(writeRam, 0, 4 + requiredSize * sizeof(char));
 	writeRam[0] = 4 + requiredSize;
 	writeRam[1] = 3;
 	memcpy(&writeRam[2], item->Address, sizeof(item->Address));
 	memcpy(&writeRam[5], dataToSend, dataAmount);
-	encode((unsigned char*)sendData, (unsigned char*)writeRam);
-	return controlBoardCommWR(clientSocket,sendData,receivedDataBuffer,16,0);
+	encode(connection->sendData, writeRam);
+	int index = getVlItemIndex(&connection->items, item);
+	if(controlBoardCommWR(connection, connection->sendData, connection->receivedData, FRAME_SIZE, 0) == 1){
+		invalidateShadowRegister(&connection->shadows, index);
+		return 1;
+	}
+	uint32_t word;
+	if(charArrayToUint32(dataToSend, dataAmount, &word) == 0){
+		setShadowRegister(&connection->shadows, index, word);
+	}
+	return 0;
 }
 
 
@@ -693,11 +938,11 @@ int writeRamF(SOCKET clientSocket, char *dataToSend, int dataAmount, VLItem *ite
  * for a board item identified by its address and type/length within `BoardItem_data`.
  * The retrieved value is stored in `defaultValue`.
  *
- * @param client Socket for communication with the control board.
+ * @param connection Connection for communication with the control board.
  * @param BoardItem_data Pointer to data with the board item's address and type/length.
  * @param defaultValue Pointer to store the retrieved default value (up to 4 bytes).
  */
-void getDefaultValue(SOCKET client, char *BoardItem_data, char *defaultValue)
+void getDefaultValue(BoardConnection *connection, char *BoardItem_data, char *defaultValue)
 {
 	char receivedDataBuffer[16] =
 	{ 0 };
@@ -706,8 +951,8 @@ void getDefaultValue(SOCKET client, char *BoardItem_data, char *defaultValue)
 	unsigned char function[6] =
 	{ 0 };
 
-	char *address = &BoardItem_data[35];
-	char *lenTyp = &BoardItem_data[38];
+	char *address = &BoardItem_data[32];
+	char *lenTyp = &BoardItem_data[35];
 	char size = lenTypToByte(lenTyp[0]);
 
 	function[0] = 5;
@@ -718,7 +963,7 @@ void getDefaultValue(SOCKET client, char *BoardItem_data, char *defaultValue)
 	}
 	function[5] = size;
 	encode(sendData, function);
-	controlBoardCommWR(client,sendData,receivedDataBuffer,16,size);
+	controlBoardCommWR(connection,sendData,receivedDataBuffer,16,size);
 	memcpy(defaultValue, &receivedDataBuffer[1], 4);
 }
 
@@ -729,17 +974,17 @@ void getDefaultValue(SOCKET client, char *BoardItem_data, char *defaultValue)
  * Sends a request to the control board and sets `boardStatus` to indicate readiness.
  * Logs the board's status.
  *
- * @param socket Socket used for communication.
+ * @param connection Connection used for communication.
  * @param boardStatus Pointer to store the board's status (0 for ready, 1 for not ready).
  * @return 1 on communication issues or if not ready, 0 if ready.
  */
-int getSocketStatus(SOCKET socket, int *boardStatus){
+int getSocketStatus(BoardConnection *connection, int *boardStatus){
 	char getStatus[] ={ 1, 0 };
-	encode((unsigned char*)sendData, (unsigned char*)getStatus);
-	if(controlBoardCommWR(socket,sendData,recieved_data,16,2)==1){
+	encode(connection->sendData, (unsigned char*)getStatus);
+	if(controlBoardCommWR(connection,connection->sendData,connection->receivedData,16,2)==1){
 		return 1;
 	}
-	if(recieved_data[0] == '\0'){
+	if(connection->receivedData[0] == '\0'){
 		logz("Socket status: OK.");
 		*boardStatus = 0;
 		return 0;
@@ -756,69 +1001,190 @@ int getSocketStatus(SOCKET socket, int *boardStatus){
  * Sends a request to the control board to get the total item count, updates `itemCount`
  * with the number of items available, and logs the result.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param itemCount Pointer to store the number of items available on the board.
  * @return 0 on success, 1 on failure to communicate with the board.
  */
-int getBoardItemCount(SOCKET socket, int *itemCount){
+int getBoardItemCount(BoardConnection *connection, int *itemCount){
 	char BoardItemCount[] ={ 1, 1 };
-	encode((unsigned char*)sendData, (unsigned char*)BoardItemCount);
-	size_t len = sizeof(sendData);
-	if(controlBoardCommWR(socket,sendData,recieved_data,len,2)==1){
+	encode(connection->sendData, (unsigned char*)BoardItemCount);
+	size_t len = sizeof(connection->sendData);
+	if(controlBoardCommWR(connection,connection->sendData,connection->receivedData,len,2)==1){
 		return 1;
 	}
-	*itemCount = (int) (unsigned char) recieved_data[1];
-	sprintf(message, "%d available Items on board",*itemCount);
-	logz(message);
+	*itemCount = (int) (unsigned char) connection->receivedData[1];
+	sprintf(connection->message, "%d available Items on board",*itemCount);
+	logz(connection->message);
 	return 0;
 }
 
 
 /**
- * Retrieves and stores information about items on the control board into a JSON file.
+ * @brief Decodes the describe reply (function 2) of a board item into its BoardItem
  *
- * Iterates through each item on the control board, fetching its information and default
- * value, and then serializes this information into a JSON array. The JSON representation
- * is saved to "boardItems.json".
+ * Called by the pipeline when the reply arrived. The request carries its BoardItem, so the reply is assigned
+ * to the right item regardless of the position of the request in the burst.
  *
- * @param socket Socket used for communication with the control board.
- * @param itemCount The number of items to fetch from the board.
- * @return 0 on successful execution and creation of JSON file, 1 on communication failure.
+ * @param request Completed describe request
+ * @param userData BoardItem of the request
  */
-int getBoardItems(SOCKET socket, int itemCount){
-	char getBoardItem[] ={ 5, 2, 0 };
-	size_t len = sizeof(sendData);
-	cJSON *output = cJSON_CreateObject();
-	cJSON *objArray = cJSON_CreateArray();
-	char defaultValue[4];
-	for (int i = 0; i < itemCount; i++)
-	{
-		getBoardItem[2] = i;
-		encode((unsigned char*)sendData, (unsigned char*)getBoardItem);
+static void boardItemDescribed(CommRequest *request, void *userData){
+	BoardItem *boardItem = userData;
+	char data[PIPELINE_MAX_REPLY];
+	if(request->status != 0){
+		return;
+	}
+	// decoded from a copy, the reply stays untouched for the fingerprint
+	memcpy(data, request->reply, request->replySize);
+	extractInformationFromData(data, 80);
+	memset(boardItem, 0, sizeof(BoardItem));
+	memcpy(boardItem->name, data, 32);
+	memcpy(boardItem->Address, data + 32, 3);
+	memcpy(boardItem->LenTyp, data + 35, 2);
+	memcpy(boardItem->Flags, data + 37, 2);
+	memcpy(boardItem->Symbol, data + 39, 10);
+	memcpy(boardItem->ScaleFactor, data + 49, 4);
+	memcpy(boardItem->Unit, data + 53, 6);
+	memcpy(boardItem->MinVal, data + 59, 4);
+	memcpy(boardItem->MaxVal, data + 63, 4);
+}
 
-		if(controlBoardCommWR(socket,sendData,recieved_data,len,70)==1){
-			return 1;
+
+/**
+ * Computes the fingerprint of the board item table. The describe frames (function 2) of all items are sent in
+ * pipelined bursts and a CRC-32 is calculated over the replies. Together with the item count and the stamp of
+ * the configuration files it identifies the catalog created for this board.
+ * The board has no cheaper identity like a firmware version, and a stale catalog would write to wrong addresses,
+ * so the table is described on every start. The replies are decoded into boardItems, a discovery after a
+ * mismatch only has to read the default values.
+ *
+ * @param connection Connection used for communication with the control board.
+ * @param itemCount The number of items on the board.
+ * @param fingerprint Pointer to store the fingerprint.
+ * @param boardItems Array of itemCount items to store the described items in, may be NULL.
+ * @return 0 on success, 1 on communication failure.
+ */
+int getBoardFingerprint(BoardConnection *connection, int itemCount, BoardFingerprint *fingerprint, BoardItem *boardItems){
+	CommPipeline pipeline;
+	CommRequest requests[PIPELINE_DEPTH];
+	unsigned char getBoardItem[] = { 5, 2, 0 };
+	int error = 0;
+
+	fingerprint->itemCount = itemCount;
+	fingerprint->tableChecksum = 0;
+	if(getConfigStamp(&fingerprint->configStamp)==1){
+		logz("Configuration files for the board fingerprint not found");
+	}
+
+	pipelineInit(&pipeline, connection);
+	for(int chunk = 0; chunk < itemCount; chunk += PIPELINE_DEPTH){
+		int chunkSize = itemCount - chunk;
+		if(chunkSize > PIPELINE_DEPTH){
+			chunkSize = PIPELINE_DEPTH;
+		}
+		for(int i = 0; i < chunkSize; i++){
+			getBoardItem[2] = chunk + i;
+			if(boardItems != NULL){
+				pipelinePrepare(&requests[i], getBoardItem, 70, boardItemDescribed, &boardItems[chunk + i]);
+			}else{
+				pipelinePrepare(&requests[i], getBoardItem, 70, NULL, NULL);
+			}
+			pipelineSubmit(&pipeline, &requests[i]);
+		}
+		if(pipelineFlush(&pipeline)==1){
+			error = 1;
+			break;
+		}
+		for(int i = 0; i < chunkSize; i++){
+			fingerprint->tableChecksum = crc32Update(fingerprint->tableChecksum, requests[i].reply, requests[i].replySize);
 		}
-		extractInformationFromData(recieved_data,80);
-		getDefaultValue(socket, recieved_data, defaultValue);
-
-		char size = lenTypToByte(recieved_data[38]);
-		BoardItemstoJson(recieved_data, defaultValue, size, objArray);
-	}
-	cJSON_AddItemToObject(output, "VLItems", objArray);
-	char *jsonString = cJSON_Print(output);
-
-	FILE *jsonFile;
-	createFileStream(&jsonFile, "boardItems.json", "w",0);
-	fprintf(jsonFile, "%s\n", jsonString);
-	closeFileStream(jsonFile,0);
-	cJSON_Delete(output);
-	free(jsonString);
-    logz("Creating boarditem.json succeeded");
+	}
+	if(error == 0){
+		sprintf(connection->message, "Board fingerprint: %d items, table checksum %08x",itemCount,(unsigned) fingerprint->tableChecksum);
+		logz(connection->message);
+	}
+	return error;
+}
+
+
+/**
+ * @brief Stores the value read from a board item as its default value
+ * @param request Completed read RAM request
+ * @param userData BoardItem of the request
+ */
+static void boardItemDefaultRead(CommRequest *request, void *userData){
+	BoardItem *boardItem = userData;
+	if(request->status != 0){
+		return;
+	}
+	memset(boardItem->DefaultValue, 0, sizeof(boardItem->DefaultValue));
+	memcpy(boardItem->DefaultValue, &request->reply[1], request->expectedBytes);
+}
+
+
+/**
+ * Reads the default value of every board item, the items have to be described already, e.g. by
+ * getBoardFingerprint. The reads are sent in pipelined bursts and decoded directly into the BoardItem array.
+ *
+ * @param connection Connection used for communication with the control board.
+ * @param boardItems Described board items, their default values are stored in them.
+ * @param itemCount The number of items.
+ * @return 0 on success, 1 on communication failure.
+ */
+int getBoardItemDefaults(BoardConnection *connection, BoardItem *boardItems, int itemCount){
+	CommPipeline pipeline;
+	int error = 0;
+
+	CommRequest *requests = malloc(itemCount * sizeof(CommRequest));
+	if(requests == NULL){
+		fprintf(stderr,"Memory allocation for the board item requests failed\n");
+		return 1;
+	}
+
+	pipelineInit(&pipeline, connection);
+	for(int i = 0; i < itemCount && error == 0; i++){
+		unsigned char readRam[] = { 5, 4, 0, 0, 0, 0 };
+		memcpy(&readRam[2], boardItems[i].Address, sizeof(boardItems[i].Address));
+		readRam[5] = lenTypToByte(boardItems[i].LenTyp[0]);
+		pipelinePrepare(&requests[i], readRam, readRam[5], boardItemDefaultRead, &boardItems[i]);
+		error |= pipelineSubmit(&pipeline, &requests[i]);
+	}
+	if(error == 0){
+		error |= pipelineFlush(&pipeline);
+	}
+	free(requests);
+
+	if(error != 0){
+		logz("Reading the board items failed");
+		return 1;
+	}
+	sprintf(connection->message, "Reading %d board items succeeded",itemCount);
+	logz(connection->message);
 	return 0;
 }
 
 
+/**
+ * Retrieves information about all items on the control board.
+ *
+ * The describe frames (function 2) of all items are sent in pipelined bursts, followed by bursts reading the
+ * default value of every item. The replies are decoded directly into the BoardItem array.
+ *
+ * @param connection Connection used for communication with the control board.
+ * @param boardItems Array to store the board items, has to hold itemCount items.
+ * @param itemCount The number of items to fetch from the board.
+ * @return 0 on success, 1 on communication failure.
+ */
+int getBoardItems(BoardConnection *connection, BoardItem *boardItems, int itemCount){
+	BoardFingerprint fingerprint;
+	if(getBoardFingerprint(connection, itemCount, &fingerprint, boardItems) == 1){
+		logz("Reading the board items failed");
+		return 1;
+	}
+	return getBoardItemDefaults(connection, boardItems, itemCount);
+}
+
+
 /**
  * Creates a bitmask based on the provided BitItem properties.
  *
@@ -863,34 +1229,38 @@ int assembleData(uint32_t *data, uint32_t value, uint32_t startBit){
  *
  * Modifies the data of a VLItem based on a bitmask and writes the updated data back.
  * Adjusts for item data size and ensures only specified bits are altered.
+ * The bits are merged into the shadow word of the item, the board is only read if the shadow word is older than
+ * the resync period. A write which leaves the word unchanged is not sent, if suppressRedundant is set.
  *
- * @param socket Communication socket.
+ * @param connection Connection to the control board.
  * @param data New bit values to apply.
  * @param bitMask Mask defining which bits to update.
  * @param item Item to be updated.
  * @return 0 if successful, 1 on error.
  */
-int setupBitData(SOCKET socket,uint32_t data,uint32_t bitMask,VLItem *item){
-	char receivedData[DEFAULT_BUFLEN] = {0};
+int setupBitData(BoardConnection *connection,uint32_t data,uint32_t bitMask,VLItem *item){
 	char senddata[4] = {0};
-	readFromBoard(socket, item->name, receivedData);
-
 	size_t requiredSize = lenTypToByte(item->LenTyp[0]);
 	uint32_t boardData;
-	charArrayToUint32(receivedData,requiredSize, &boardData);
-	boardData = (boardData & ~bitMask) | (data & bitMask);
 
-	if(requiredSize == 2){
-		senddata[0] = (char)((boardData >> 8) & 0xFF);
-		senddata[1] = (char)(boardData  & 0xFF);
+	if(getShadowRegister(&connection->shadows, getVlItemIndex(&connection->items, item), &boardData) == 0){
+		countShadowHit(&connection->stats);
 	}else{
-		senddata[0] = (char)((boardData >> 24) & 0xFF);
-		senddata[1] = (char)((boardData >> 16) & 0xFF);
-		senddata[2] = (char)((boardData >> 8) & 0xFF);
-		senddata[3] = (char)(boardData & 0xFF);
+		char receivedData[DEFAULT_BUFLEN] = {0};
+		if(readFromBoard(connection, item->name, receivedData) == 1){
+			fprintf(stderr,"Error reading from board occurred while writing to Item : %s",item->name);
+			return 1;
+		}
+		charArrayToUint32(receivedData,requiredSize, &boardData);
+	}
+	uint32_t mergedData = (boardData & ~bitMask) | (data & bitMask);
+	if(connection->shadows.suppressRedundant && mergedData == boardData){
+		countSuppressedWrite(&connection->stats);
+		return 0;
 	}
-	uint32ToCharArray(boardData, senddata, requiredSize);
-	if(writeRamF(socket, senddata, requiredSize, item)==1){
+
+	uint32ToCharArray(mergedData, senddata, requiredSize);
+	if(writeRamF(connection, senddata, requiredSize, item)==1){
 		fprintf(stderr,"Error writing to board occurred while writing to Item : %s",item->name);
 		return 1;
 	}
@@ -905,115 +1275,84 @@ int setupBitData(SOCKET socket,uint32_t data,uint32_t bitMask,VLItem *item){
  * retrieves the corresponding item or bit item structure, and writes the provided
  * data to the control board. Supports writing to both full items and individual bits
  * within items, handling bit masks and data shifting as needed.
+ * The names are split into stack buffers and the item is taken from the cache, nothing is allocated.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param input A string specifying the item and optionally the bit item (e.g., "item.bit").
  * @param data The data to write to the specified item or bit item.
- * @return 0 on success, 1 on failure due to various reasons like memory allocation failure,
- *         item or bit item not found, or write operation failure.
+ * @return 0 on success, 1 on failure due to various reasons like item or bit item not found,
+ *         data exceeding the bit item, or write operation failure.
  */
-int writeToBoard(SOCKET socket, char *input, uint32_t data){
-	size_t length = strlen(input);
-	char *itemName = malloc(length*sizeof(char));
-	char *bitName = NULL;
-
-	int i;
-	for (i = 0; i < length && input[i] != '.'; i++) {
-		itemName[i] = input[i];
-	}
-
-	itemName[i] = '\0'; // Null-terminate the first part
-
-	if (input[i] == '.') {
-		bitName = malloc(length*sizeof(char));
-		if(bitName == NULL)return 1;
-		strcpy(bitName, input + i + 1);
-	}
+int writeToBoard(BoardConnection *connection, char *input, uint32_t data){
+	char itemName[sizeof(((VLItem*)0)->name)];
+	char bitName[sizeof(((BitItem*)0)->bitName)];
+	VLItem *item;
+	BitItem *bitItem = NULL;
 
-	VLItem item;
-	if(getVLItem(&item,itemName)==1){
+	if(splitItemName(input, itemName, bitName) == 1 || getVLItem(connection, &item, itemName) == 1){
 		return 1;
 	}
-
-	BitItem *bitItem = NULL;
-	if(bitName != NULL){
-		for(int i=0;i<item.BitItemCount;i++){
-			if(0==strcmp(item.BitItems[i].bitName,bitName)){
-				bitItem = &item.BitItems[i];
-			}
-		}
-		if(item.BitItemCount == 0){
-			sprintf(message,"Board Write Operation : failed. Error: Item (%s) does not have BitItems.",itemName);
-			logz(message);
+	if(bitName[0] != '\0'){
+		if(item->BitItemCount <= 0){
+			sprintf(connection->message,"Board Write Operation : failed. Error: Item (%s) does not have BitItems.",itemName);
+			logz(connection->message);
 			fprintf(stderr,"Item (%s) does not have BitItems",itemName);
 			fflush(stderr);
 			return 1;
 		}
-		if(bitItem == NULL){
-			sprintf(message,"Board Write Operation : failed. Error: BitItem with the name : (%s) not found in Item (%s)",bitName,itemName);
-			logz(message);
+		if(getBitItemFromVlItem(item, bitName, &bitItem) == 1){
+			sprintf(connection->message,"Board Write Operation : failed. Error: BitItem with the name : (%s) not found in Item (%s)",bitName,itemName);
+			logz(connection->message);
 			fprintf(stderr,"BitItem with the name : (%s) not found in Item (%s)",bitName,itemName);
 			fflush(stderr);
 			return 1;
 		}
-	}else{
-		if(item.BitItemCount > 0){
-			sprintf(message,"Board Write Operation : failed. Error: Item (%s) consists of BitItems. Provide BitItem like \"itemName.bitName\"",itemName);
-			logz(message);
-			fprintf(stderr,"Item (%s) consists of BitItems. Provide BitItem like \"itemName.bitName\"",itemName);
-			fflush(stderr);
-			return 1;
-		}
+	}else if(item->BitItemCount > 0){
+		sprintf(connection->message,"Board Write Operation : failed. Error: Item (%s) consists of BitItems. Provide BitItem like \"itemName.bitName\"",itemName);
+		logz(connection->message);
+		fprintf(stderr,"Item (%s) consists of BitItems. Provide BitItem like \"itemName.bitName\"",itemName);
+		fflush(stderr);
+		return 1;
 	}
-	char *dataToSend;
-	if(item.BitItemCount <=0){
-		size_t size;
-		if(lenTypToByte(item.LenTyp[0])==2){
-			dataToSend = malloc(sizeof(char)*2);
-			if(dataToSend == NULL)return 1;
 
-			uint32ToCharArray(data, dataToSend, 2);
-			size = 2;
-		}else{
-			dataToSend = malloc(sizeof(char)*4);
-			if(dataToSend == NULL)return 1;
-			uint32ToCharArray(data, dataToSend, 4);
-			size = 4;
-		}
-		if(writeRamF(socket, dataToSend, size,&item)==1){
-			sprintf(message,"Board Write Operation : failed. Value \"%d\" for Item (%s) could'nt be written",data,itemName);
-			logz(message);
+	if(bitItem == NULL){
+		char dataToSend[4];
+		size_t size = lenTypToByte(item->LenTyp[0]);
+		uint32ToCharArray(data, dataToSend, size);
+		if(writeRamF(connection, dataToSend, size, item)==1){
+			sprintf(connection->message,"Board Write Operation : failed. Value \"%u\" for Item (%s) could'nt be written",data,itemName);
+			logz(connection->message);
 			return 1;
 		}
 
-		if(item.LenTyp[0]== 9 || item.LenTyp[0]==11){
-			sprintf(message,"Board Write Operation : Item '%s' , Value= %u",itemName, data);
-			logz(message);
+		if(item->LenTyp[0]== 9 || item->LenTyp[0]==11){
+			if(isBoardTraceOpen(&connection->trace) == 0){
+				sprintf(connection->message,"Board Write Operation : Item '%s' , Value= %u",itemName, data);
+				logz(connection->message);
+			}
 		}
 		return 0;
-	}else{
-		if(data>(1<<(bitItem->size -1))){
-			sprintf(message,"Board Write Operation : failed. Error: Data not possible to send. Data to big. "
-					"MaxSize for %s.%s is: %d. Data size tried to send %d\n",itemName,bitName,(1<<bitItem->size),data);
-			logz(message);
-			fprintf(stderr,"Data not possible to send. Data to big. MaxSize for %s.%s is: %d. Data size tried to send %d\n",
-			itemName,bitName,(1<<bitItem->size),data);
-			fflush(stderr);
-			return 1;
-		}
+	}
 
-		uint32_t bitMask = 0;
-		createBitMask(&bitMask, bitItem);
-		//data need to be shifted to startbit position
-		data = data<<bitItem->startBit;
-		if(setupBitData(socket,data,bitMask,&item)==1){
-			sprintf(message,"Board Write Operation : failed. Value \"%d\" for BitItem (%s) in Item (%s) could'nt be written",data,bitName,itemName);
-			logz(message);
-			return 1;
-		}
+	if(bitItem->size < 32 && data >= (1u << bitItem->size)){
+		sprintf(connection->message,"Board Write Operation : failed. Error: Data not possible to send. Data to big. "
+				"MaxSize for %s.%s is: %u. Data size tried to send %u",itemName,bitName,(1u<<bitItem->size)-1,data);
+		logz(connection->message);
+		fprintf(stderr,"Data not possible to send. Data to big. MaxSize for %s.%s is: %u. Data size tried to send %u\n",
+				itemName,bitName,(1u<<bitItem->size)-1,data);
+		fflush(stderr);
+		return 1;
+	}
+
+	uint32_t bitMask = 0;
+	createBitMask(&bitMask, bitItem);
+	//data need to be shifted to startbit position
+	data = data<<bitItem->startBit;
+	if(setupBitData(connection,data,bitMask,item)==1){
+		sprintf(connection->message,"Board Write Operation : failed. Value \"%u\" for BitItem (%s) in Item (%s) could'nt be written",data,bitName,itemName);
+		logz(connection->message);
+		return 1;
 	}
-	free(itemName);
-	free(bitName);
 	return 0;
 }
 
@@ -1025,17 +1364,19 @@ int writeToBoard(SOCKET socket, char *input, uint32_t data){
  * writes this value to the control board using the `writeToBoard` function. It
  * logs the operation indicating the item being written to and the float value.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param input A string specifying the item (and optionally the bit item) to write to.
  * @param data The floating-point data to write to the specified item.
  * @return Returns the result from `writeToBoard`: 0 on success, 1 on failure.
  */
-int writeToBoardFloat(SOCKET socket, char *input, float data){
+int writeToBoardFloat(BoardConnection *connection, char *input, float data){
 	uint32_t dataint;
 	memcpy(&dataint, &data, sizeof(unsigned int));
-	sprintf(message,"Board Write Operation : Item '%s' , Value= %f ",input, data);
-	logz(message);
-	return writeToBoard(socket, input, dataint);
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message,"Board Write Operation : Item '%s' , Value= %f ",input, data);
+		logz(connection->message);
+	}
+	return writeToBoard(connection, input, dataint);
 }
 
 
@@ -1046,16 +1387,18 @@ int writeToBoardFloat(SOCKET socket, char *input, float data){
  * input format of the `writeToBoard` function. It logs the operation, indicating
  * the item being written to and the integer value.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param input A string specifying the item (and optionally the bit item) to write to.
  * @param data The 16-bit integer data to write to the specified item.
  * @return Returns the result from `writeToBoard`: 0 on success, 1 on failure.
  */
-int writeToBoardInt16(SOCKET socket, char *input, int16_t data){
+int writeToBoardInt16(BoardConnection *connection, char *input, int16_t data){
 	uint32_t unsignedData = (uint32_t)data;
-	sprintf(message,"Board Write Operation : Item '%s' , Value= %d ",input, data);
-	logz(message);
-	return writeToBoard(socket, input, unsignedData);
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message,"Board Write Operation : Item '%s' , Value= %d ",input, data);
+		logz(connection->message);
+	}
+	return writeToBoard(connection, input, unsignedData);
 }
 
 
@@ -1066,16 +1409,18 @@ int writeToBoardInt16(SOCKET socket, char *input, int16_t data){
  * `writeToBoard` function. Logs the operation, showing the item targeted and
  * the integer value being written.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param input String identifying the item (and optionally a bit item) to be written.
  * @param data The 32-bit integer data to write to the specified item.
  * @return Returns the result from `writeToBoard`: 0 if successful, 1 on failure.
  */
-int writeToBoardInt32(SOCKET socket, char *input, int32_t data){
+int writeToBoardInt32(BoardConnection *connection, char *input, int32_t data){
 	uint32_t unsignedData = (uint32_t)data;
-	sprintf(message,"Board Write Operation : Item '%s' , Value= %d ",input, data);
-	logz(message);
-	return writeToBoard(socket, input, unsignedData);
+	if(isBoardTraceOpen(&connection->trace) == 0){
+		sprintf(connection->message,"Board Write Operation : Item '%s' , Value= %d ",input, data);
+		logz(connection->message);
+	}
+	return writeToBoard(connection, input, unsignedData);
 }
 
 
@@ -1086,30 +1431,30 @@ int writeToBoardInt32(SOCKET socket, char *input, int32_t data){
  * and writes this value to the board according to the item's data type. Handles
  * various data types by calling the appropriate function for each type.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param itemName The name of the item whose initial value is to be written.
  * @return Returns 0 on successful write, 1 on error such as item not found, initial
  *         value not set, or unsupported data type.
  */
-int writeToBoardInitValue(SOCKET socket, char *itemName){
-	VLItem item;
-	if(getVLItem(&item,itemName)==1){
+int writeToBoardInitValue(BoardConnection *connection, char *itemName){
+	VLItem *item;
+	if(getVLItem(connection, &item, itemName)==1){
 		return 1;
 	}
-	if(item.Value == NAN){
+	if(item->Value == NAN){
 		fprintf(stderr,"Initial Value is null. Value cannot be written");
 	}
-	size_t datatyp = (size_t) item.LenTyp[0];
+	size_t datatyp = (size_t) item->LenTyp[0];
 	if(datatyp == 8){
-		return writeToBoardInt16(socket,itemName,(int)item.Value);
+		return writeToBoardInt16(connection,itemName,(int)item->Value);
 	}else if(datatyp == 9){
-		return writeToBoard(socket,itemName,(uint16_t)item.Value);
+		return writeToBoard(connection,itemName,(uint16_t)item->Value);
 	}else if(datatyp == 10){
-		return writeToBoardInt32(socket,itemName,(int32_t) item.Value);
+		return writeToBoardInt32(connection,itemName,(int32_t) item->Value);
 	}else if(datatyp == 11){
-		return writeToBoard(socket,itemName,(uint32_t) item.Value);
+		return writeToBoard(connection,itemName,(uint32_t) item->Value);
 	}else if(datatyp == 12){
-		return writeToBoardFloat(socket,itemName,item.Value);
+		return writeToBoardFloat(connection,itemName,item->Value);
 	}else{
 		fprintf(stderr,"Error. Given Data type not known. Value cannot not written");
 		return 1;
@@ -1125,22 +1470,22 @@ int writeToBoardInitValue(SOCKET socket, char *itemName){
  * to clear (set to 0) all associated bit items. It then calls `setupBitData`
  * to apply the bitmask, effectively clearing the bit items on the board.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param vlitemName The name of the VLItem whose bit items are to be cleared.
  * @return Returns 0 if the bit items were successfully cleared, 1 on error, such
  *         as failure to retrieve the VLItem or to create the bitmask.
  */
-int clearBoardBitItems(SOCKET socket,char *vlitemName){
-	VLItem item;
+int clearBoardBitItems(BoardConnection *connection,char *vlitemName){
+	VLItem *item;
 	uint32_t bitMask = 0;
 	uint32_t data = 0;
-	if(getVLItem(&item,vlitemName)==1){
+	if(getVLItem(connection, &item, vlitemName)==1){
 		return 1;
 	}
-	for(int j=0; j<item.BitItemCount; j++){
-		if(createBitMask(&bitMask,&(item.BitItems[j]))==1)return 1;
+	for(int j=0; j<item->BitItemCount; j++){
+		if(createBitMask(&bitMask,&(item->BitItems[j]))==1)return 1;
 	}
-	return setupBitData(socket,data,bitMask,&item);
+	return setupBitData(connection,data,bitMask,item);
 }
 
 
@@ -1151,7 +1496,7 @@ int clearBoardBitItems(SOCKET socket,char *vlitemName){
  * values to specified bit items. It constructs a bitmask and data value based on
  * the bit items' positions and the given values, then applies these to the board.
  *
- * @param socket Socket used for communication with the control board.
+ * @param connection Connection used for communication with the control board.
  * @param vlitemName Name of the VLItem containing the bit items to be written.
  * @param bitItemName Array of names for the bit items to be written.
  * @param values Array of values corresponding to each bit item.
@@ -1159,9 +1504,9 @@ int clearBoardBitItems(SOCKET socket,char *vlitemName){
  * @return Returns 0 on success, 1 on error such as failure to retrieve the VLItem,
  *         to find a specified bit item, or to apply the data and bitmask.
  */
-int writeToBoardBitItems(SOCKET socket,char *vlitemName, char *bitItemName[], uint32_t values[],size_t size){
-	VLItem item;
-	if(getVLItem(&item,vlitemName)==1){
+int writeToBoardBitItems(BoardConnection *connection,char *vlitemName, char *bitItemName[], uint32_t values[],size_t size){
+	VLItem *item;
+	if(getVLItem(connection, &item, vlitemName)==1){
 		return 1;
 	}
 	uint32_t bitMask = 0;
@@ -1172,7 +1517,260 @@ int writeToBoardBitItems(SOCKET socket,char *vlitemName, char *bitItemName[], ui
 			createBitMask(&bitMask, bitItem);
 			assembleData(&data, values[i], bitItem->startBit);
 	}
-	return setupBitData(socket,data,bitMask,&item);
+	return setupBitData(connection,data,bitMask,item);
+}
+
+
+/**
+ * @brief Initialises an empty write batch
+ * @param batch Batch to initialise
+ * @param connection Connection the batch is flushed to
+ */
+void writeBatchInit(BoardWriteBatch *batch, BoardConnection *connection){
+	batch->connection = connection;
+	batch->count = 0;
+}
+
+
+/**
+ * Returns the batch entry of a VLItem, creating a new entry if the item is not queued yet. An entry already queued
+ * is moved to the end of the batch, so the coalesced word is sent at the position of the last write to its item.
+ *
+ * @param batch Batch to search.
+ * @param item VLItem the entry belongs to.
+ * @return Pointer to the entry, NULL if the batch is full.
+ */
+static BoardWrite* getBatchEntry(BoardWriteBatch *batch, VLItem *item){
+	BoardConnection *connection = batch->connection;
+	for(size_t i = 0; i < batch->count; i++){
+		if(strcmp(batch->writes[i].name, item->name) == 0){
+			BoardWrite entry = batch->writes[i];
+			memmove(&batch->writes[i], &batch->writes[i + 1], (batch->count - i - 1) * sizeof(BoardWrite));
+			batch->writes[batch->count - 1] = entry;
+			return &batch->writes[batch->count - 1];
+		}
+	}
+	if(batch->count == WRITE_BATCH_SIZE){
+		sprintf(connection->message,"Board Write Operation : failed. Error: Write batch is full, Item (%s) not queued.",item->name);
+		logz(connection->message);
+		return NULL;
+	}
+	BoardWrite *write = &batch->writes[batch->count++];
+	strcpy(write->name, item->name);
+	memcpy(write->address, item->Address, sizeof(write->address));
+	write->lenTyp = item->LenTyp[0];
+	write->index = getVlItemIndex(&connection->items, item);
+	write->data = 0;
+	write->bitMask = 0;
+	write->status = COMM_PENDING;
+	return write;
+}
+
+
+/**
+ * Queues a write to an item or bit item. Writes to the same VLItem are coalesced: plain items keep the last value,
+ * bit items are merged into one masked word. The coalesced write is sent in the order of the last write queued to
+ * its item. Names and values are validated when queueing, nothing is sent until writeBatchFlush is called.
+ *
+ * @param batch Batch to queue the write in.
+ * @param input A string specifying the item and optionally the bit item (e.g., "item.bit").
+ * @param data The data to write to the specified item or bit item.
+ * @return 0 on success, 1 if the item or bit item is not valid or the batch is full.
+ */
+int writeBatchAdd(BoardWriteBatch *batch, char *input, uint32_t data){
+	BoardConnection *connection = batch->connection;
+	char itemName[sizeof(((VLItem*)0)->name)];
+	char bitName[sizeof(((BitItem*)0)->bitName)];
+	VLItem *item;
+	BitItem *bitItem = NULL;
+
+	if(splitItemName(input, itemName, bitName) == 1 || getVLItem(connection, &item, itemName) == 1){
+		return 1;
+	}
+	if(bitName[0] != '\0'){
+		if(item->BitItemCount <= 0 || getBitItemFromVlItem(item, bitName, &bitItem) == 1){
+			sprintf(connection->message,"Board Write Operation : failed. Error: BitItem with the name : (%s) not found in Item (%s)",bitName,itemName);
+			logz(connection->message);
+			return 1;
+		}
+		if(bitItem->size < 32 && data >= (1u << bitItem->size)){
+			sprintf(connection->message,"Board Write Operation : failed. Error: Data not possible to send. Data to big. "
+					"MaxSize for %s.%s is: %u. Data size tried to send %u",itemName,bitName,(1u<<bitItem->size)-1,data);
+			logz(connection->message);
+			return 1;
+		}
+	}else if(item->BitItemCount > 0){
+		sprintf(connection->message,"Board Write Operation : failed. Error: Item (%s) consists of BitItems. Provide BitItem like \"itemName.bitName\"",itemName);
+		logz(connection->message);
+		return 1;
+	}
+
+	BoardWrite *write = getBatchEntry(batch, item);
+	if(write == NULL){
+		return 1;
+	}
+	if(bitItem != NULL){
+		uint32_t bitMask = 0;
+		createBitMask(&bitMask, bitItem);
+		write->data = (write->data & ~bitMask) | ((data << bitItem->startBit) & bitMask);
+		write->bitMask |= bitMask;
+	}else{
+		write->data = data;
+		write->bitMask = 0xFFFFFFFF;
+	}
+	return 0;
+}
+
+
+/**
+ * Queues a floating-point write to an item.
+ *
+ * @param batch Batch to queue the write in.
+ * @param input A string specifying the item to write to.
+ * @param data The floating-point data to write.
+ * @return Returns the result from `writeBatchAdd`: 0 on success, 1 on failure.
+ */
+int writeBatchAddFloat(BoardWriteBatch *batch, char *input, float data){
+	uint32_t dataint;
+	memcpy(&dataint, &data, sizeof(uint32_t));
+	return writeBatchAdd(batch, input, dataint);
+}
+
+
+/**
+ * Queues clearing all bit items of a VLItem, equivalent to `clearBoardBitItems`.
+ *
+ * @param batch Batch to queue the write in.
+ * @param vlitemName The name of the VLItem whose bit items are to be cleared.
+ * @return 0 on success, 1 if the item is not found or the batch is full.
+ */
+int writeBatchClearBitItems(BoardWriteBatch *batch, char *vlitemName){
+	BoardConnection *connection = batch->connection;
+	VLItem *item;
+	uint32_t bitMask = 0;
+	if(getVLItem(connection, &item, vlitemName) == 1){
+		return 1;
+	}
+	BoardWrite *write = getBatchEntry(batch, item);
+	if(write == NULL){
+		return 1;
+	}
+	for(int j = 0; j < item->BitItemCount; j++){
+		createBitMask(&bitMask, &(item->BitItems[j]));
+	}
+	write->data &= ~bitMask;
+	write->bitMask |= bitMask;
+	return 0;
+}
+
+
+/**
+ * Sends all queued writes in pipelined bursts. Bit items, which do not cover the complete item word, need the
+ * current word of the board: it is taken from the shadow word of the item if that is recent, otherwise these are
+ * read in one burst first. The queued bits are merged into the words, afterwards all words are written in a
+ * second burst. Bit words left unchanged are not sent, if suppressRedundant is set. The result of every entry is
+ * stored in its status.
+ *
+ * @param batch Batch to flush to the connection it was initialised with. It is empty afterwards.
+ * @return 0 if all entries were written, 1 if at least one entry failed.
+ */
+int writeBatchFlush(BoardWriteBatch *batch){
+	BoardConnection *connection = batch->connection;
+	CommPipeline pipeline;
+	CommRequest requests[PIPELINE_DEPTH];
+	int readBack[PIPELINE_DEPTH];			// 0 whole word written, 1 word from the shadow, 2 word read from the board
+	uint32_t boardWords[PIPELINE_DEPTH];
+	int error = 0;
+
+	pipelineInit(&pipeline, connection);
+	for(size_t chunk = 0; chunk < batch->count; chunk += PIPELINE_DEPTH){
+		size_t chunkSize = batch->count - chunk;
+		if(chunkSize > PIPELINE_DEPTH){
+			chunkSize = PIPELINE_DEPTH;
+		}
+
+		// read the words of partially written bit items
+		int readNeeded = 0;
+		for(size_t i = 0; i < chunkSize; i++){
+			BoardWrite *write = &batch->writes[chunk + i];
+			size_t size = lenTypToByte(write->lenTyp);
+			uint32_t wordMask = size == 2 ? 0xFFFF : 0xFFFFFFFF;
+			readBack[i] = (write->bitMask & wordMask) != wordMask;
+			if(!readBack[i]){
+				continue;
+			}
+			if(getShadowRegister(&connection->shadows, write->index, &boardWords[i]) == 0){
+				countShadowHit(&connection->stats);
+				continue;
+			}
+			unsigned char readRam[] = { 5, 4, 0, 0, 0, 0 };
+			memcpy(&readRam[2], write->address, sizeof(write->address));
+			readRam[5] = size;
+			pipelinePrepare(&requests[i], readRam, size, NULL, NULL);
+			pipelineSubmit(&pipeline, &requests[i]);
+			readBack[i] = 2;
+			readNeeded = 1;
+		}
+		if(readNeeded){
+			pipelineFlush(&pipeline);
+		}
+
+		for(size_t i = 0; i < chunkSize; i++){
+			BoardWrite *write = &batch->writes[chunk + i];
+			size_t size = lenTypToByte(write->lenTyp);
+			uint32_t boardData = 0;
+			if(readBack[i] == 2){
+				if(requests[i].status != 0){
+					write->status = 1;
+					continue;
+				}
+				charArrayToUint32(&requests[i].reply[1], size, &boardData);
+				setShadowRegister(&connection->shadows, write->index, boardData);
+			}else if(readBack[i]){
+				boardData = boardWords[i];
+			}
+			write->data = (boardData & ~write->bitMask) | (write->data & write->bitMask);
+			if(readBack[i] && connection->shadows.suppressRedundant && write->data == boardData){
+				countSuppressedWrite(&connection->stats);
+				write->status = 0;
+				continue;
+			}
+
+			unsigned char writeRam[FRAME_SIZE] = { 0 };
+			writeRam[0] = 4 + size;
+			writeRam[1] = 3;
+			memcpy(&writeRam[2], write->address, sizeof(write->address));
+			uint32ToCharArray(write->data, (char*) &writeRam[5], size);
+			pipelinePrepare(&requests[i], writeRam, 0, NULL, NULL);
+			pipelineSubmit(&pipeline, &requests[i]);
+			write->status = COMM_PENDING;
+		}
+		pipelineFlush(&pipeline);
+
+		for(size_t i = 0; i < chunkSize; i++){
+			BoardWrite *write = &batch->writes[chunk + i];
+			if(write->status == COMM_PENDING){
+				write->status = requests[i].status == 0 ? 0 : 1;
+				if(write->status == 0){
+					setShadowRegister(&connection->shadows, write->index, write->data);
+				}else{
+					invalidateShadowRegister(&connection->shadows, write->index);
+				}
+			}
+			if(write->status == 0){
+				if(isBoardTraceOpen(&connection->trace) == 0){
+					sprintf(connection->message,"Board Write Operation : Item '%s' , Value= %u (batched)",write->name, write->data);
+					logz(connection->message);
+				}
+			}else{
+				sprintf(connection->message,"Board Write Operation : failed. Value \"%u\" for Item (%s) could'nt be written",write->data,write->name);
+				logz(connection->message);
+				error = 1;
+			}
+		}
+	}
+	batch->count = 0;
+	return error;
 }
 
 
@@ -1183,41 +1781,34 @@ int writeToBoardBitItems(SOCKET socket,char *vlitemName, char *bitItemName[], ui
  * with bit fields, it uses a bitmask to set specific bits. For regular items, it directly writes
  * the default value. Handles both cases with appropriate data preparation and communication functions.
  *
- * @param socket Communication socket with the control board.
+ * @param connection Connection to the control board.
  * @param vLItemCount Number of VLItems to initialize.
  * @return 0 if setup is successful for all items, 1 on any failure.
  */
-int setupBoard(SOCKET socket,int vLItemCount){
-	VLItem item;
+int setupBoard(BoardConnection *connection,int vLItemCount){
+	VLItem *item;
 	for(int i=0;i<vLItemCount;i++){
-		if(getVLItembyNr(&item, i)==1){
+		if(getVLItemByNr(connection, &item, i)==1){
 			printf("Search of ItemNr %d failed.\n",i);
 			return 1;
 		}
-		if(item.BitItemCount>0){
+		if(item->BitItemCount>0){
 			uint32_t bitMask = 0;
 			uint32_t data = 0;
 
-			for(int j=0; j<item.BitItemCount; j++){
-				if(item.BitItems[j].value!=-1){
-					createBitMask(&bitMask,&(item.BitItems[j]));
-					assembleData(&data,item.BitItems[j].value,item.BitItems[j].startBit);
+			for(int j=0; j<item->BitItemCount; j++){
+				if(item->BitItems[j].value!=-1){
+					createBitMask(&bitMask,&(item->BitItems[j]));
+					assembleData(&data,item->BitItems[j].value,item->BitItems[j].startBit);
 				}
 			}
-			setupBitData(socket, data, bitMask, &item);
+			setupBitData(connection, data, bitMask, item);
 		}else{
-			char *dataToSend;
-			if(item.Value!=NAN){
-				size_t size;
-				if(lenTypToByte(item.LenTyp[0])==2){
-					dataToSend = malloc(sizeof(char)*2);
-					size = 2;
-				}else{
-					dataToSend = malloc(sizeof(char)*4);
-					size = 4;
-				}
-				doubleToCharArray(item.Value, dataToSend,size);
-				writeRamF(socket, dataToSend, size, &item);
+			char dataToSend[4];
+			if(item->Value!=NAN){
+				size_t size = lenTypToByte(item->LenTyp[0]);
+				doubleToCharArray(item->Value, dataToSend,size);
+				writeRamF(connection, dataToSend, size, item);
 			}
 		}
 	}
@@ -8,44 +8,103 @@
 #ifndef SOCKET_UTILS_H_
 #define SOCKET_UTILS_H_
 
-#define DEFAULT_BUFLEN 128
 #define IP_ADDRESS "192.168.0.2"
 #define PORT 1000
-#include <winsock2.h>
 #include <stdint.h>
-#include <ws2tcpip.h>
+#include "sockets.h"
 #include "json_utils.h"
-void encode(unsigned char *data, unsigned char *function);
-void recv_dataf(SOCKET socket, char *receivedDataBuffer, int expectedBytes);
-char lenTypToByte(char lenTyp);
-void getDefaultValue(SOCKET client, char *vlitem_data, char *defaultValue);
-int getVLItem(VLItem *item,char*item_name);
-
-int createConnection(SOCKET *socket, char* ip_Address, int port);
-int getSocketStatus(SOCKET socket, int *boardStatus);
-int getBoardItemCount(SOCKET socket, int *itemcnt);
-int getBoardItems(SOCKET socket, int itemCount);
-int getBoardItem(SOCKET socket, char *receivedDataBuffer, int itemNumber);
-int writeRamF(SOCKET clientSocket, char *dataToSend, int dataAmount, VLItem *item);
-int setupBoard(SOCKET socket,int vLItemCount);
-
-int readFromBoard(SOCKET clientSocket, char *receivedDataBuffer, char *item_name);
-
-int readFromBoardInt16(SOCKET clientSocket, char *item_name, int *num);
-int readFromBoardUInt16(SOCKET clientSocket, char *item_name, uint16_t *num);
-int readFromBoardInt32(SOCKET clientSocket, char *item_name, int32_t *num);
-int readFromBoardUInt32(SOCKET clientSocket, char *item_name, uint32_t *num);
-int readFromBoardFloat(SOCKET clientSocket, char *item_name, float *num);
-int readFromBoardBitItem(SOCKET clientSocket, char *input, uint32_t *data);
-
-int writeToBoard(SOCKET socket, char *input, uint32_t data);
-int writeToBoardFloat(SOCKET socket, char *input, float data);
-int writeToBoardInt16(SOCKET socket, char *input, int16_t data);
-int writeToBoardInt32(SOCKET socket, char *input, int32_t data);
-int writeToBoardBitItems(SOCKET socket,char *vlitemName, char **bitItemName,uint32_t *values,size_t size);
-int clearBoardBitItems(SOCKET socket,char *vlitemName);
-
-int cleanup(SOCKET socket);
+#include "vlitem_catalog.h"
+#include "board_connection.h"
+
+typedef union
+{
+	int16_t i16;
+	uint16_t u16;
+	int32_t i32;
+	uint32_t u32;
+	float f;
+} BoardValue;
+
+typedef struct
+{
+	char *name;				// item name, bit items in dot-notation like "item.bitName"
+	char expectedLenTyp;	// required length type of plain items, 0 accepts every type
+	char lenTyp;			// length type of the read item
+	int isBitItem;
+	BoardValue value;
+	int status;				// 0 on success, 1 on failure
+} BoardRead;
+
+#define WRITE_BATCH_SIZE 128
+
+typedef struct
+{
+	char name[35];
+	char address[3];
+	char lenTyp;
+	int index;				// position of the item in the VLItem cache, selects its shadow word
+	uint32_t data;
+	uint32_t bitMask;		// bits of the item word written by this entry
+	int status;				// COMM_PENDING until flushed, 0 on success, 1 on failure
+} BoardWrite;
+
+typedef struct
+{
+	BoardConnection *connection;
+	BoardWrite writes[WRITE_BATCH_SIZE];
+	size_t count;
+} BoardWriteBatch;
+
+int encode(unsigned char *data, unsigned char *function);
+int recv_dataf(BoardConnection *connection, char *receivedDataBuffer, int expectedBytes);
+int replyFrameSize(int expectedBytes);
+int checkReplyChecksum(char *receivedDataBuffer, int totalBytes);
+int controlBoardCommWR(BoardConnection *connection, unsigned char *bytesToSend,char *bytesToReceive, size_t bytesToSendSize, size_t bytesToReceiveSize);
+size_t lenTypToByte(char lenTyp);
+int extractInformationFromData(char *recievedData, int expectedBytes);
+void getDefaultValue(BoardConnection *connection, char *vlitem_data, char *defaultValue);
+int getVLItem(BoardConnection *connection, VLItem **item, char *item_name);
+int getVLItemByNr(BoardConnection *connection, VLItem **item, int i);
+int bypassBoardShadow(BoardConnection *connection, char *item_name);
+int loadVLItems(BoardConnection *connection);
+int openBoardCatalog(BoardConnection *connection, BoardFingerprint *fingerprint);
+int createBoardCatalog(BoardConnection *connection, BoardFingerprint *fingerprint, VLItem *vlItems, int count);
+
+int createConnection(BoardConnection *connection, char* ip_Address, int port);
+int getSocketStatus(BoardConnection *connection, int *boardStatus);
+int getBoardItemCount(BoardConnection *connection, int *itemcnt);
+int getBoardItems(BoardConnection *connection, BoardItem *boardItems, int itemCount);
+int getBoardItemDefaults(BoardConnection *connection, BoardItem *boardItems, int itemCount);
+int getBoardFingerprint(BoardConnection *connection, int itemCount, BoardFingerprint *fingerprint, BoardItem *boardItems);
+int getBoardItem(BoardConnection *connection, char *receivedDataBuffer, int itemNumber);
+int writeRamF(BoardConnection *connection, char *dataToSend, int dataAmount, VLItem *item);
+int setupBoard(BoardConnection *connection,int vLItemCount);
+
+int readFromBoard(BoardConnection *connection, char *item_name, char *data);
+
+int readFromBoardInt16(BoardConnection *connection, char *item_name, int *num);
+int readFromBoardUInt16(BoardConnection *connection, char *item_name, uint16_t *num);
+int readFromBoardInt32(BoardConnection *connection, char *item_name, int32_t *num);
+int readFromBoardUInt32(BoardConnection *connection, char *item_name, uint32_t *num);
+int readFromBoardFloat(BoardConnection *connection, char *item_name, float *num);
+int readFromBoardBitItem(BoardConnection *connection, char *input, uint32_t *data);
+int readFromBoardMany(BoardConnection *connection, BoardRead *reads, size_t count);
+int splitItemName(const char *input, char *itemName, char *bitName);
+
+int writeToBoard(BoardConnection *connection, char *input, uint32_t data);
+int writeToBoardFloat(BoardConnection *connection, char *input, float data);
+int writeToBoardInt16(BoardConnection *connection, char *input, int16_t data);
+int writeToBoardInt32(BoardConnection *connection, char *input, int32_t data);
+int writeToBoardBitItems(BoardConnection *connection,char *vlitemName, char **bitItemName,uint32_t *values,size_t size);
+int clearBoardBitItems(BoardConnection *connection,char *vlitemName);
+
+void writeBatchInit(BoardWriteBatch *batch, BoardConnection *connection);
+int writeBatchAdd(BoardWriteBatch *batch, char *input, uint32_t data);
+int writeBatchAddFloat(BoardWriteBatch *batch, char *input, float data);
+int writeBatchClearBitItems(BoardWriteBatch *batch, char *vlitemName);
+int writeBatchFlush(BoardWriteBatch *batch);
+
+int cleanup(BoardConnection *connection);
 
 #endif /* SOCKET_UTILS_H_ */
 
@@ -4,14 +4,23 @@
  *  Simple (incomplete) compatibility header file to make it easier to
  *  write portable sockets-based C programs for Linux and Windows.
  *  This is meant to be just good enough for the simple NDK examples.
+ *
+ *  The POSIX branch is selected by the CMake option POSIX_BACKEND, or
+ *  automatically when compiling with gcc on Linux.
  */
 #ifndef _SOCKETS_H_
 #define _SOCKETS_H_
 
-#if defined(__GNUC__) && defined(linux)
+#if !defined(POSIX_BACKEND) && defined(__GNUC__) && defined(__linux__)
+#define POSIX_BACKEND
+#endif
+
+#if defined(POSIX_BACKEND)
 
 #include <errno.h>
 #include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -19,13 +28,14 @@
 
 typedef int SOCKET;
 
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+
 #define closesocket(s) close(s)
 
 /* these are not needed for Linux */
 #define socketsShutdown()
-#define socketsStartup()
-
-#define kbhit() 0
+#define socketsStartup() (0)
 
 #define getError() (errno)
 
@@ -40,6 +50,12 @@ typedef int SOCKET;
 
 #define socketsShutdown() WSACleanup()
 
+static __inline int socketsStartup(void)
+{
+    WSADATA wsaData;
+    return WSAStartup(MAKEWORD(2, 2), &wsaData);
+}
+
 static __inline int inet_pton(int af, const char * src, void * dst)
 {
     int status = 0;
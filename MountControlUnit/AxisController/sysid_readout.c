@@ -0,0 +1,184 @@
+/**
+ * @file sysid_readout.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Readout of the sysid results after a sweep
+ *
+ * @details The board holds the result of one frequency point at a time: writing sysid_index selects a point, once
+ *	sysid_status.indexToRead shows the index, sysid_amp, sysid_phase and sysid_freq hold its result. Reading every
+ *	point with separate transactions and a fixed 40 ms wait for the selection took tens of seconds per sweep.
+ *	The readout sends one pipelined burst per point instead: the status and the three results of the selected
+ *	point are read and the index of the next point is written behind them, so the board already selects the next
+ *	point while the reply travels back. The board processes the frames in order, the results are therefore
+ *	consistent with the status read in front of them. If the status shows the point wasn't selected yet, the
+ *	index is set back and the burst is repeated later.
+ *	If a request of a burst had to be sent again, the pipeline repeated it behind the write of the next index, so
+ *	the burst is thrown away, the index is set back and the burst is repeated as well.
+ *	The wait before a burst adapts to the board: it is doubled after every miss and reduced by a quarter after
+ *	every hit, so it settles just above the time the board needs to select a point.
+ **/
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "sysid_readout.h"
+#include "item_handle.h"
+#include "comm_pipeline.h"
+#include "timing_utils.h"
+#include "logz.h"
+
+enum { SYSID_STATUS, SYSID_AMPLITUDE, SYSID_PHASE, SYSID_FREQUENCY, SYSID_INDEX, SYSID_ITEMS };
+
+static const char *sysidItemNames[SYSID_ITEMS] = {
+	"sysid_status.indexToRead", "sysid_amp", "sysid_phase", "sysid_freq", "sysid_index"
+};
+
+
+/**
+ * @brief Releases the handles of the sysid items
+ * @param handles Handles, unresolved ones are NULL
+ */
+static void releaseSysidItems(ItemHandle *handles[SYSID_ITEMS]){
+	for(int i = 0; i < SYSID_ITEMS; i++){
+		releaseItem(handles[i]);
+		handles[i] = NULL;
+	}
+}
+
+
+/**
+ * Reads the results of all points of a finished sweep into memory.
+ *
+ * @param connection Connection to the board
+ * @param points Array of at least length points to store the results in, index 1 is stored in points[0]
+ * @param length Number of points of the sweep, at most SYSID_MAX_POINTS
+ * @param stats Pointer to store the statistics of the readout, may be NULL
+ * @return 0 if all points were read, 1 otherwise
+ */
+int readSysidResults(BoardConnection *connection, SysidPoint *points, uint32_t length, SysidReadoutStats *stats){
+	ItemHandle *handles[SYSID_ITEMS] = { NULL };
+	CommPipeline pipeline;
+	CommRequest requests[SYSID_ITEMS];
+	SysidReadoutStats readout = { 0 };
+	uint64_t start = monotonicNs();
+	uint64_t wait = SYSID_POLL_MIN_NS;
+	uint32_t point = 1;
+	int error = 0;
+	int retried;
+
+	if(length == 0 || length > SYSID_MAX_POINTS){
+		return 1;
+	}
+	for(int i = 0; i < SYSID_ITEMS; i++){
+		if(resolveItem(connection, sysidItemNames[i], &handles[i]) == 1){
+			sprintf(connection->message,"Sysid Readout: failed. Error: Item (%s) not found.",sysidItemNames[i]);
+			logz(connection->message);
+			releaseSysidItems(handles);
+			return 1;
+		}
+	}
+
+	pipelineInit(&pipeline, connection);
+	uint64_t selectedAt = monotonicNs();	// last selection of the current point
+	uint64_t pointSince = selectedAt;		// first selection of the current point
+	if(writeItem(connection, handles[SYSID_INDEX], point) == 1){
+		releaseSysidItems(handles);
+		return 1;
+	}
+	while(point <= length){
+		sleepUntilNs(selectedAt + wait);
+
+		// results of the selected point, followed by the selection of the next one
+		int next = point < length;
+		int count = next ? SYSID_ITEMS : SYSID_INDEX;
+		for(int i = SYSID_STATUS; i < SYSID_INDEX; i++){
+			prepareItemRead(handles[i], &requests[i]);
+		}
+		if(next){
+			prepareItemWrite(connection, handles[SYSID_INDEX], &requests[SYSID_INDEX], point + 1);
+		}
+		uint64_t sentAt = monotonicNs();
+		for(int i = 0; i < count; i++){
+			pipelineSubmit(&pipeline, &requests[i]);
+		}
+		pipelineFlush(&pipeline);
+		readout.polls++;
+
+		uint32_t values[SYSID_INDEX];
+		retried = 0;
+		for(int i = SYSID_STATUS; i < SYSID_INDEX; i++){
+			if(getItemValue(connection, handles[i], &requests[i], &values[i]) == 1){
+				error = 1;
+			}
+		}
+		for(int i = 0; i < count; i++){
+			retried |= requests[i].retries > 0;
+		}
+		if(error || (next && requests[SYSID_INDEX].status != 0)){
+			sprintf(connection->message,"Sysid Readout: failed. Error: Point %u couldn't be read.",point);
+			logz(connection->message);
+			error = 1;
+			break;
+		}
+
+		if(!retried && values[SYSID_STATUS] == point){
+			SysidPoint *result = &points[point - 1];
+			memcpy(&result->amplitude, &values[SYSID_AMPLITUDE], sizeof(float));
+			memcpy(&result->phase, &values[SYSID_PHASE], sizeof(float));
+			memcpy(&result->frequency, &values[SYSID_FREQUENCY], sizeof(float));
+			readout.points++;
+			point++;
+			wait -= wait / 4;
+			if(wait < SYSID_POLL_MIN_NS){
+				wait = SYSID_POLL_MIN_NS;
+			}
+			selectedAt = sentAt;
+			pointSince = sentAt;
+			continue;
+		}
+
+		if(monotonicNs() - pointSince > SYSID_SELECT_TIMEOUT_NS){
+			sprintf(connection->message,"Sysid Readout: failed. Error: Point %u wasn't selected by the board.",point);
+			logz(connection->message);
+			error = 1;
+			break;
+		}
+		if(retried){
+			// a repeated read was executed after the next index was written, the results can belong to the next point
+			readout.repeats++;
+		}else{
+			// not selected yet, the next point was selected too early
+			readout.misses++;
+			wait *= 2;
+			if(wait > SYSID_POLL_MAX_NS){
+				wait = SYSID_POLL_MAX_NS;
+			}
+		}
+		selectedAt = monotonicNs();
+		if(next && writeItem(connection, handles[SYSID_INDEX], point) == 1){
+			error = 1;
+			break;
+		}
+	}
+
+	releaseSysidItems(handles);
+	readout.duration = monotonicNs() - start;
+	readout.wait = wait;
+	if(stats != NULL){
+		*stats = readout;
+	}
+	return error;
+}
+
+
+/**
+ * @brief Prints the statistics of a readout
+ * @param stats Statistics returned by readSysidResults
+ * @param stream Stream to print to, e.g. stdout
+ */
+void printSysidReadoutStats(SysidReadoutStats *stats, FILE *stream){
+	fprintf(stream, "Sysid readout: %" PRIu32 " points in %.1f ms, %" PRIu32 " polls, %" PRIu32 " misses, "
+			"%" PRIu32 " repeated, wait %.2f ms\n", stats->points, stats->duration / 1000000.0, stats->polls,
+			stats->misses, stats->repeats, stats->wait / 1000000.0);
+}
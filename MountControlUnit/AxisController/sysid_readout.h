@@ -0,0 +1,40 @@
+/*
+ * sysid_readout.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef SYSID_READOUT_H_
+#define SYSID_READOUT_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "board_connection.h"
+
+#define SYSID_MAX_POINTS 511
+#define SYSID_POLL_MIN_NS 100000ULL			// shortest wait for the board to select a point
+#define SYSID_POLL_MAX_NS 40000000ULL		// longest wait between two polls, the fixed wait of the old readout
+#define SYSID_SELECT_TIMEOUT_NS 2000000000ULL	// a point not selected within this time fails the readout
+
+typedef struct
+{
+	float amplitude;
+	float phase;		// in rad
+	float frequency;	// in Hz
+} SysidPoint;
+
+typedef struct
+{
+	uint32_t points;	// points read
+	uint32_t polls;		// bursts sent to the board
+	uint32_t misses;	// polls which found the point not selected yet
+	uint32_t repeats;	// polls thrown away because a request of them was sent again
+	uint64_t duration;	// in ns
+	uint64_t wait;		// adapted wait for the board to select a point at the end of the readout, in ns
+} SysidReadoutStats;
+
+int readSysidResults(BoardConnection *connection, SysidPoint *points, uint32_t length, SysidReadoutStats *stats);
+void printSysidReadoutStats(SysidReadoutStats *stats, FILE *stream);
+
+#endif /* SYSID_READOUT_H_ */
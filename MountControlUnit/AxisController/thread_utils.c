@@ -0,0 +1,288 @@
+/*
+ * thread_utils.c
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ *
+ * Storage of the semaphores and task flags shared between the axle threads, declared in thread_utils.h, and the
+ * launcher of the axle threads.
+ *
+ * Every axle runs its position loop in its own thread. A page fault or a migration to another core in that loop
+ * shows up as a spike of several milliseconds, so the launcher pins the thread to its own core, runs it with
+ * SCHED_FIFO priority, locks the memory of the process and touches the stack and the per thread transport state
+ * before the loop starts. Missing privileges (CAP_SYS_NICE, CAP_IPC_LOCK) only produce a warning, the axle then
+ * runs with the default scheduling.
+ * Helper threads like the log writer and the pollers never inherit the scheduling of the thread starting them,
+ * they are created with explicit attributes by startHelperThread. A real time helper is kept off the core of the
+ * thread starting it: the axle would preempt it there and could then wait for it forever.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE		// pthread_setaffinity_np
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "thread_utils.h"
+#include "transport.h"
+
+#ifdef POSIX_BACKEND
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#endif
+
+sem_t sharedDir;
+sem_t schedule_sem_1;
+sem_t schedule_sem_2;
+int write_task_identify;
+int read_task_identify;
+
+static pthread_once_t memoryLocked = PTHREAD_ONCE_INIT;
+
+
+/**
+ * @brief Fills the arguments of an axle with the default core and priority
+ * @param arguments Arguments to fill
+ * @param axleNum Number of the axle, starting at 1
+ * @param ipAddress Address of the board of the axle
+ * @param port Port of the board
+ */
+void initAxleArguments(AxleArguments *arguments, int axleNum, const char *ipAddress, int port){
+	memset(arguments, 0, sizeof(AxleArguments));
+	arguments->axleNum = axleNum;
+	strncpy(arguments->ip_address, ipAddress, sizeof(arguments->ip_address) - 1);
+	arguments->port = port;
+	arguments->cpu = AXLE_FIRST_CPU + axleNum - 1;
+	arguments->priority = AXLE_THREAD_PRIORITY;
+}
+
+
+#ifdef POSIX_BACKEND
+
+/**
+ * Locks all current and future pages of the process in RAM. The allocator is told to keep freed memory, memory
+ * returned to the OS would be faulted in again by the next allocation.
+ *
+ * @return 0 on success, 1 otherwise
+ */
+int lockProcessMemory(){
+#ifdef __GLIBC__
+	mallopt(M_TRIM_THRESHOLD, -1);
+	mallopt(M_MMAP_MAX, 0);
+#endif
+	if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0){
+		fprintf(stderr,"WARNING: Memory couldn't be locked, errno %d\n", errno);
+		return 1;
+	}
+	return 0;
+}
+
+
+static int pinThread(int cpu){
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(cpu, &cpus);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+
+
+static int raisePriority(int priority){
+	struct sched_param parameter = { .sched_priority = priority };
+	return pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameter);
+}
+
+
+/**
+ * Sets the scheduling of a helper thread in its attributes. A real time helper gets at most the priority below the
+ * calling thread and runs on the cores of the process except the ones of the calling thread. If the calling thread
+ * may run on all of them, the helper shares its core and gets its priority, so it can't be preempted by it. A
+ * helper without real time priority runs on all cores of the process.
+ *
+ * @param attributes Attributes of the new thread
+ * @param priority Requested SCHED_FIFO priority, 0 for the time sharing scheduler
+ * @return 0 on success, 1 otherwise
+ */
+static int setHelperScheduling(pthread_attr_t *attributes, int priority){
+	struct sched_param parameter = { .sched_priority = 0 };
+	int policy = SCHED_OTHER;
+	int callerPolicy;
+	struct sched_param caller;
+	cpu_set_t cpus;
+	int hasCpus = sched_getaffinity(getpid(), sizeof(cpus), &cpus) == 0;
+
+	if(pthread_getschedparam(pthread_self(), &callerPolicy, &caller) == 0 && callerPolicy == SCHED_FIFO
+			&& priority > 0){
+		policy = SCHED_FIFO;
+		parameter.sched_priority = priority < caller.sched_priority ? priority : caller.sched_priority - 1;
+		if(parameter.sched_priority < 1){
+			parameter.sched_priority = 1;
+		}
+		cpu_set_t own;
+		cpu_set_t others;
+		if(hasCpus && pthread_getaffinity_np(pthread_self(), sizeof(own), &own) == 0){
+			CPU_XOR(&others, &cpus, &own);
+			CPU_AND(&others, &others, &cpus);
+			if(CPU_COUNT(&others) > 0){
+				pthread_attr_setaffinity_np(attributes, sizeof(others), &others);
+			}else{
+				// a lower priority on the same core would let the caller preempt it in the middle of a publish
+				parameter.sched_priority = caller.sched_priority;
+			}
+		}
+	}else if(hasCpus){
+		pthread_attr_setaffinity_np(attributes, sizeof(cpus), &cpus);
+	}
+	return pthread_attr_setinheritsched(attributes, PTHREAD_EXPLICIT_SCHED) != 0
+			|| pthread_attr_setschedpolicy(attributes, policy) != 0
+			|| pthread_attr_setschedparam(attributes, &parameter) != 0;
+}
+
+#else
+
+// Windows has no equivalent of mlockall, the working set of the process is left to the OS
+int lockProcessMemory(){
+	return 0;
+}
+
+
+static int pinThread(int cpu){
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) == 0;
+}
+
+
+static int raisePriority(int priority){
+	(void)priority;
+	return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) == 0;
+}
+
+
+// Windows threads start with the normal priority and on all cores, nothing is inherited
+static int setHelperScheduling(pthread_attr_t *attributes, int priority){
+	(void)attributes;
+	(void)priority;
+	return 0;
+}
+
+#endif
+
+
+static void lockMemoryOnce(){
+	lockProcessMemory();
+}
+
+
+// Touches every page of the given part of the stack, so the loop below this frame does not fault
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void prefaultStack(){
+	volatile char stack[AXLE_STACK_PREFAULT_SIZE];
+	for(size_t i = 0; i < sizeof(stack); i += 1024){
+		stack[i] = 0;
+	}
+}
+
+
+/**
+ * Prepares the calling thread to run the control loop of an axle: sets the axle variables of the thread, pins it
+ * to its core, raises its priority and touches its stack and the epoll instance.
+ * Can be called at the start of any thread running an axle, startAxleThread calls it before the entry.
+ *
+ * @param arguments Axle, board address, core and priority of the thread
+ * @return 0 if all settings were applied, 1 if one of them failed, the thread is usable in both cases
+ */
+int configureAxleThread(const AxleArguments *arguments){
+	int error = 0;
+
+	axleNum = arguments->axleNum;
+	memcpy(axleIPAdress, arguments->ip_address, sizeof(axleIPAdress));
+	axleIPAdress[sizeof(axleIPAdress) - 1] = '\0';
+	axlePort = arguments->port;
+
+	if(arguments->cpu != AXLE_CPU_UNPINNED && pinThread(arguments->cpu) != 0){
+		fprintf(stderr,"WARNING: Axle %d couldn't be pinned to core %d\n", axleNum, arguments->cpu);
+		error = 1;
+	}
+	if(arguments->priority > 0 && raisePriority(arguments->priority) != 0){
+		fprintf(stderr,"WARNING: Axle %d runs without real time priority\n", axleNum);
+		error = 1;
+	}
+	prefaultStack();
+	if(transportPrepare() == 1){
+		fprintf(stderr,"WARNING: Transport of axle %d couldn't be prepared\n", axleNum);
+		error = 1;
+	}
+	fflush(stderr);
+	return error;
+}
+
+
+static void* runAxleThread(void *arg){
+	AxleThread *axle = (AxleThread*)arg;
+	axle->configured = configureAxleThread(&axle->arguments);
+	axle->result = axle->entry();
+	return NULL;
+}
+
+
+/**
+ * Starts the control routine of an axle in a new thread. The memory of the process is locked once by the first
+ * started axle.
+ *
+ * @param axleThread Arguments and entry of the axle, has to stay valid until joinAxleThread returned
+ * @return 0 on success, 1 otherwise
+ */
+int startAxleThread(AxleThread *axleThread){
+	pthread_attr_t attributes;
+
+	pthread_once(&memoryLocked, lockMemoryOnce);
+	if(pthread_attr_init(&attributes) != 0){
+		return 1;
+	}
+	pthread_attr_setstacksize(&attributes, AXLE_THREAD_STACK_SIZE);
+	int status = pthread_create(&axleThread->thread, &attributes, runAxleThread, axleThread);
+	pthread_attr_destroy(&attributes);
+	if(status != 0){
+		fprintf(stderr,"ERROR: Thread of axle %d couldn't be started\n", axleThread->arguments.axleNum);
+		return 1;
+	}
+	return 0;
+}
+
+
+int joinAxleThread(AxleThread *axleThread){
+	return pthread_join(axleThread->thread, NULL) != 0;
+}
+
+
+/**
+ * Starts a helper thread, e.g. the log writer or a poller. Unlike a thread created with default attributes it
+ * doesn't inherit the real time priority and the core of an axle: with priority 0 it runs with the time sharing
+ * scheduler on all cores of the process, otherwise with SCHED_FIFO below the calling thread on the other cores of
+ * the process. If the calling thread has no real time priority, neither has the helper.
+ *
+ * @param thread Pointer to store the thread
+ * @param routine Routine of the thread
+ * @param argument Passed to the routine
+ * @param priority SCHED_FIFO priority, e.g. HELPER_THREAD_PRIORITY, or 0
+ * @return 0 on success, 1 otherwise
+ */
+int startHelperThread(pthread_t *thread, void *(*routine)(void*), void *argument, int priority){
+	pthread_attr_t attributes;
+
+	if(pthread_attr_init(&attributes) != 0){
+		return 1;
+	}
+	pthread_attr_setstacksize(&attributes, HELPER_THREAD_STACK_SIZE);
+	if(setHelperScheduling(&attributes, priority) != 0){
+		pthread_attr_destroy(&attributes);
+		return 1;
+	}
+	int status = pthread_create(thread, &attributes, routine, argument);
+	pthread_attr_destroy(&attributes);
+	return status != 0;
+}
@@ -6,23 +6,62 @@
  */
 
 #ifndef THREAD_UTILS_H_
-#define THREAD_UTILS_H
+#define THREAD_UTILS_H_
 
 
 #include <semaphore.h> // Include the header file for sem_t
+#include <pthread.h>
+#include "sockets.h"
+
+#ifndef AXLE_THREAD_PRIORITY
+#define AXLE_THREAD_PRIORITY 80		// SCHED_FIFO priority of the axle threads, above the log writer and the OS helpers
+#endif
+#ifndef AXLE_FIRST_CPU
+#define AXLE_FIRST_CPU 1			// axle n runs on core AXLE_FIRST_CPU + n - 1, core 0 is left to the OS
+#endif
+#ifndef HELPER_THREAD_PRIORITY
+#define HELPER_THREAD_PRIORITY 70	// SCHED_FIFO priority of the pollers of an axle, below its control loop and off its core
+#endif
+#define AXLE_CPU_UNPINNED (-1)
+#define AXLE_THREAD_STACK_SIZE (1024 * 1024)
+#define HELPER_THREAD_STACK_SIZE (256 * 1024)	// locked in RAM like every stack, so kept small
+#define AXLE_STACK_PREFAULT_SIZE (256 * 1024)	// stack touched before the control loop, covers the pipelines
 
 extern __thread int axleNum; // Thread specific variable defining the axle
 extern __thread char axleIPAdress[16];
 extern __thread int axlePort;
-extern __thread SOCKET clientSocket;
 
 
-sem_t sharedDir; //global semaphore for managing shared directory
-sem_t schedule_sem_1;
-sem_t schedule_sem_2;
-sem_t axle_1_ready;
-sem_t axle_2_ready;
-int write_task_identify;
-int read_task_identify;
+// defined once in thread_utils.c
+extern sem_t sharedDir; //global semaphore for managing shared directory
+extern sem_t schedule_sem_1;
+extern sem_t schedule_sem_2;
+extern int write_task_identify;
+extern int read_task_identify;
+
+typedef struct
+{
+	int axleNum;
+	char ip_address[16];
+	int port;
+	int cpu;		// core the thread is pinned to, AXLE_CPU_UNPINNED keeps the affinity of the process
+	int priority;	// SCHED_FIFO priority from 1 to 99, 0 keeps the time sharing scheduler
+} AxleArguments;
+
+typedef struct
+{
+	AxleArguments arguments;
+	unsigned int (*entry)();	// control routine of the axle, e.g. axleController
+	pthread_t thread;
+	int configured;				// result of configureAxleThread in the started thread
+	unsigned int result;		// return value of the entry
+} AxleThread;
+
+void initAxleArguments(AxleArguments *arguments, int axleNum, const char *ipAddress, int port);
+int lockProcessMemory();
+int configureAxleThread(const AxleArguments *arguments);
+int startAxleThread(AxleThread *axleThread);
+int joinAxleThread(AxleThread *axleThread);
+int startHelperThread(pthread_t *thread, void *(*routine)(void*), void *argument, int priority);
 
 #endif /* THREAD_UTILS_H_ */
@@ -0,0 +1,152 @@
+/**
+ * @file timing_utils.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Monotonic clock and precise sleeping
+ *
+ * @details A plain OS sleep wakes up late by the timer slack of the scheduler, a busy wait is exact but keeps a
+ *	core at full load for the whole pause. sleepUntilNs combines both: it waits in the OS until the spin threshold
+ *	before the deadline and spins on the monotonic clock only for the remaining time.
+ *	The POSIX backend waits with clock_nanosleep on the absolute deadline, so an interrupted wait neither drifts
+ *	nor restarts the pause. The Winsock backend waits on a high resolution waitable timer of the thread, on
+ *	Windows versions without high resolution timers the threshold has to cover the coarser timer tick. The timer
+ *	is created on the first wait of a thread and closed when the thread exits.
+ **/
+
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "sockets.h"
+#include "timing_utils.h"
+
+// set once before the axle threads are started, read by every sleep
+static uint64_t spinThreshold = TIMING_SPIN_THRESHOLD_NS;
+
+#ifdef POSIX_BACKEND
+
+uint64_t monotonicNs() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+
+// Waits in the OS until the absolute deadline, signals interrupting the wait do not shift the wakeup
+static void waitUntilNs(uint64_t deadline) {
+	struct timespec wakeup = { deadline / 1000000000ULL, deadline % 1000000000ULL };
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, NULL) == EINTR) {
+	}
+}
+
+#else
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+static pthread_key_t waitTimerKey;		// waitable timer of the thread, closed by closeWaitTimer
+static pthread_once_t waitTimerOnce = PTHREAD_ONCE_INIT;
+
+// Destructor of waitTimerKey, called on the exit of a thread which waited at least once
+static void closeWaitTimer(void *timer) {
+	CloseHandle((HANDLE)timer);
+}
+
+static void createWaitTimerKey() {
+	pthread_key_create(&waitTimerKey, closeWaitTimer);
+}
+
+// Returns the waitable timer of the calling thread, it is created on the first call, NULL if that failed
+static HANDLE getWaitTimer() {
+	pthread_once(&waitTimerOnce, createWaitTimerKey);
+	HANDLE timer = pthread_getspecific(waitTimerKey);
+	if (timer == NULL) {
+		timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (timer == NULL) {
+			// high resolution timers are available since Windows 10 1803
+			timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+		}
+		if (timer != NULL && pthread_setspecific(waitTimerKey, timer) != 0) {
+			CloseHandle(timer);
+			timer = NULL;
+		}
+	}
+	return timer;
+}
+
+uint64_t monotonicNs() {
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	QueryPerformanceCounter(&counter);
+	// split the conversion, counter * 1e9 would overflow after a few hours
+	uint64_t seconds = counter.QuadPart / frequency.QuadPart;
+	uint64_t remainder = counter.QuadPart % frequency.QuadPart;
+	return seconds * 1000000000ULL + remainder * 1000000000ULL / frequency.QuadPart;
+}
+
+
+// Waits in the OS until the deadline, the waitable timer only takes relative times on the monotonic clock
+static void waitUntilNs(uint64_t deadline) {
+	uint64_t now = monotonicNs();
+	if (now >= deadline) {
+		return;
+	}
+	HANDLE waitTimer = getWaitTimer();
+	LARGE_INTEGER dueTime;
+	dueTime.QuadPart = -(LONGLONG)((deadline - now) / 100);	// negative: relative time in 100 ns
+	if (waitTimer == NULL || !SetWaitableTimer(waitTimer, &dueTime, 0, NULL, NULL, FALSE)) {
+		Sleep((DWORD)((deadline - now) / 1000000ULL));
+		return;
+	}
+	WaitForSingleObject(waitTimer, INFINITE);
+}
+
+#endif
+
+
+/**
+ * @brief Sets the time before the deadline from which a precise sleep spins instead of waiting in the OS
+ *
+ * Larger thresholds compensate a late wakeup of the OS at the cost of CPU time, 0 disables spinning.
+ *
+ * @param thresholdNs Threshold in nanoseconds
+ */
+void setSpinThreshold(uint64_t thresholdNs) {
+	spinThreshold = thresholdNs;
+}
+
+
+uint64_t getSpinThreshold() {
+	return spinThreshold;
+}
+
+
+/**
+ * @brief Sleeps until the monotonic clock reaches the deadline
+ *
+ * Waits in the OS until the spin threshold before the deadline and spins for the rest of the time.
+ *
+ * @param deadline Wakeup time on the clock of monotonicNs
+ */
+void sleepUntilNs(uint64_t deadline) {
+	uint64_t threshold = spinThreshold;
+	if (deadline > threshold && monotonicNs() < deadline - threshold) {
+		waitUntilNs(deadline - threshold);
+	}
+	while (monotonicNs() < deadline) {
+	}
+}
+
+
+void sleep_us(int microseconds) {
+	sleepUntilNs(monotonicNs() + (uint64_t)microseconds * 1000ULL);
+}
+
+
+void sleep_ms(int milliseconds) {
+	waitUntilNs(monotonicNs() + (uint64_t)milliseconds * 1000000ULL);
+}
@@ -0,0 +1,33 @@
+/*
+ * timing_utils.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef TIMING_UTILS_H_
+#define TIMING_UTILS_H_
+
+#include <stdint.h>
+
+#ifndef TIMING_SPIN_THRESHOLD_NS
+#define TIMING_SPIN_THRESHOLD_NS 50000	// default length of the spun end of every precise sleep
+#endif
+
+// Monotonic timestamp in nanoseconds, only meaningful as a difference
+uint64_t monotonicNs();
+
+// Length of the end of a precise sleep which is spun instead of waited for in the OS
+void setSpinThreshold(uint64_t thresholdNs);
+uint64_t getSpinThreshold();
+
+// Sleep until the monotonic time reaches the deadline in nanoseconds
+void sleepUntilNs(uint64_t deadline);
+
+// Sleep for a specified number of microseconds
+void sleep_us(int microseconds);
+
+// Sleep for a specified number of milliseconds without spinning, gives the CPU to other threads
+void sleep_ms(int milliseconds);
+
+#endif /* TIMING_UTILS_H_ */
@@ -0,0 +1,238 @@
+/**
+ * @file transport.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Socket I/O of the board connection
+ *
+ * @details All bytes exchanged with the board pass transportSend and transportRecv, which behave like send and
+ *	recv. The Winsock backend keeps the socket blocking. The POSIX backend switches it to non-blocking mode and
+ *	waits for readiness with epoll, so a board which stops answering is detected after TRANSPORT_TIMEOUT_MS
+ *	instead of blocking the axle thread forever. Every thread owns one epoll instance, the socket it talks to is
+ *	registered on the first wait.
+ **/
+
+#include <stdint.h>
+#include "transport.h"
+
+#ifdef POSIX_BACKEND
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+
+static __thread int epollFd = -1;
+static __thread SOCKET watchedSocket = INVALID_SOCKET;
+static __thread uint32_t watchedEvents;
+
+
+/**
+ * @brief Registers the socket with the epoll instance of the thread for the given events
+ * @param socket Socket to watch
+ * @param events EPOLLIN or EPOLLOUT
+ * @return 0 on success, 1 otherwise
+ */
+static int watchSocket(SOCKET socket, uint32_t events){
+	struct epoll_event event;
+
+	if(epollFd < 0){
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+		if(epollFd < 0){
+			return 1;
+		}
+	}
+	if(watchedSocket == socket && watchedEvents == events){
+		return 0;
+	}
+	if(watchedSocket != socket && watchedSocket != INVALID_SOCKET){
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, watchedSocket, NULL);
+	}
+	event.events = events;
+	event.data.fd = socket;
+	int operation = watchedSocket == socket ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+	if(epoll_ctl(epollFd, operation, socket, &event) != 0){
+		// closing a socket drops its registration, and a new socket can get the number of the closed one
+		operation = errno == ENOENT ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+		if(epoll_ctl(epollFd, operation, socket, &event) != 0){
+			watchedSocket = INVALID_SOCKET;
+			return 1;
+		}
+	}
+	watchedSocket = socket;
+	watchedEvents = events;
+	return 0;
+}
+
+
+/**
+ * @brief Waits until the socket is ready for the given events
+ * @param socket Socket to wait for
+ * @param events EPOLLIN or EPOLLOUT
+ * @return 1 if the socket is ready, 0 after TRANSPORT_TIMEOUT_MS, -1 on error
+ */
+static int waitSocket(SOCKET socket, uint32_t events){
+	struct epoll_event event;
+	int ready;
+
+	if(watchSocket(socket, events) == 1){
+		return -1;
+	}
+	do{
+		ready = epoll_wait(epollFd, &event, 1, TRANSPORT_TIMEOUT_MS);
+	}while(ready < 0 && errno == EINTR);
+	if(ready == 0){
+		errno = ETIMEDOUT;
+	}
+	return ready;
+}
+
+
+/**
+ * @brief Creates the epoll instance of the calling thread, otherwise it is created by the first wait for the board
+ * @return 0 on success, 1 otherwise
+ */
+int transportPrepare(){
+	if(epollFd < 0){
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+	}
+	return epollFd < 0;
+}
+
+
+/**
+ * @brief Closes the epoll instance of the calling thread, called by threads ending before the process
+ */
+void transportRelease(){
+	if(epollFd >= 0){
+		close(epollFd);
+		epollFd = -1;
+	}
+	watchedSocket = INVALID_SOCKET;
+}
+
+
+/**
+ * Connects the socket to the board. The socket is switched to non-blocking mode and Nagle's algorithm is
+ * disabled, the small frames would otherwise be held back until the previous one was acknowledged.
+ *
+ * @param socket Unconnected TCP socket
+ * @param address Address of the board
+ * @return 0 on success, 1 otherwise, the cause is left in getError()
+ */
+int transportConnect(SOCKET socket, struct sockaddr_in *address){
+	int enable = 1;
+	int error = 0;
+	socklen_t length = sizeof(error);
+
+	setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+	int flags = fcntl(socket, F_GETFL, 0);
+	if(flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) < 0){
+		return 1;
+	}
+	if(connect(socket, (struct sockaddr*) address, sizeof(*address)) == 0){
+		return 0;
+	}
+	if(errno != EINPROGRESS || waitSocket(socket, EPOLLOUT) != 1){
+		return 1;
+	}
+	if(getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &length) != 0){
+		return 1;
+	}
+	if(error != 0){
+		errno = error;
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * Sends up to length bytes, waits at most TRANSPORT_TIMEOUT_MS for space in the send buffer.
+ *
+ * @param socket Connected socket
+ * @param buffer Bytes to send
+ * @param length Number of bytes
+ * @return Number of bytes sent, -1 on error or timeout
+ */
+int transportSend(SOCKET socket, const char *buffer, int length){
+	while(1){
+		ssize_t bytesSent = send(socket, buffer, length, MSG_NOSIGNAL);
+		if(bytesSent >= 0){
+			return (int) bytesSent;
+		}
+		if(errno == EINTR){
+			continue;
+		}
+		if((errno != EAGAIN && errno != EWOULDBLOCK) || waitSocket(socket, EPOLLOUT) != 1){
+			return -1;
+		}
+	}
+}
+
+
+/**
+ * Receives up to length bytes, waits at most TRANSPORT_TIMEOUT_MS for the board to answer.
+ *
+ * @param socket Connected socket
+ * @param buffer Destination of the received bytes
+ * @param length Size of the buffer
+ * @return Number of bytes received, 0 if the connection was closed, -1 on error or timeout
+ */
+int transportRecv(SOCKET socket, char *buffer, int length){
+	while(1){
+		ssize_t bytesRead = recv(socket, buffer, length, 0);
+		if(bytesRead >= 0){
+			return (int) bytesRead;
+		}
+		if(errno == EINTR){
+			continue;
+		}
+		if((errno != EAGAIN && errno != EWOULDBLOCK) || waitSocket(socket, EPOLLIN) != 1){
+			return -1;
+		}
+	}
+}
+
+
+/**
+ * @brief Removes the socket from the epoll instance of the thread and closes it
+ * @param socket Socket to close
+ */
+void transportClose(SOCKET socket){
+	if(watchedSocket == socket){
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, NULL);
+		watchedSocket = INVALID_SOCKET;
+	}
+	closesocket(socket);
+}
+
+#else
+
+int transportPrepare(){
+	return 0;
+}
+
+
+void transportRelease(){
+}
+
+
+int transportConnect(SOCKET socket, struct sockaddr_in *address){
+	return connect(socket, (struct sockaddr*) address, sizeof(*address)) != 0;
+}
+
+
+int transportSend(SOCKET socket, const char *buffer, int length){
+	return send(socket, buffer, length, 0);
+}
+
+
+int transportRecv(SOCKET socket, char *buffer, int length){
+	return recv(socket, buffer, length, 0);
+}
+
+
+void transportClose(SOCKET socket){
+	closesocket(socket);
+}
+
+#endif
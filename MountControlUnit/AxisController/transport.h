@@ -0,0 +1,22 @@
+/*
+ * transport.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef TRANSPORT_H_
+#define TRANSPORT_H_
+
+#include "sockets.h"
+
+#define TRANSPORT_TIMEOUT_MS 2000	// longest wait for the board to accept or answer a frame, POSIX backend only
+
+int transportPrepare();
+void transportRelease();
+int transportConnect(SOCKET socket, struct sockaddr_in *address);
+int transportSend(SOCKET socket, const char *buffer, int length);
+int transportRecv(SOCKET socket, char *buffer, int length);
+void transportClose(SOCKET socket);
+
+#endif /* TRANSPORT_H_ */
@@ -0,0 +1,429 @@
+/**
+ * @file vlitem_catalog.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Binary catalog of all VLItems
+ *
+ * @details vlItem.json is parsed once and serialised into vlItem.bin, a versioned binary image holding every
+ *	field of the VLItems as one contiguous array (struct-of-arrays). The image is the in-memory catalog as well
+ *	as the file format, so later starts map the file instead of parsing JSON again. The file is mapped copy on
+ *	write, changes to the items in memory never reach the file.
+ *	Every catalog carries the fingerprint of the board item table and of the configuration files it was created
+ *	from. As long as both match, the board item discovery can be skipped on start.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "vlitem_catalog.h"
+#include "vlitem_handler.h"
+#include "common_utils.h"
+
+#define CATALOG_ALIGN(x) (((x) + 7) & ~(size_t)7)
+
+// size of one element of every catalog array
+static const size_t elementSize[CATALOG_ARRAY_COUNT] = {
+	35, 3, 2, 2, 10, 4, 6, 4, 4, 4, sizeof(double), 256, 256, sizeof(uint32_t), sizeof(uint32_t), sizeof(BitItem)
+};
+
+
+/**
+ * @brief Computes the offsets of all arrays and the size of a catalog
+ * @param header Header with itemCount and bitItemCount set, offsets and fileSize are filled in
+ * @return Size of the catalog in bytes
+ */
+static size_t layoutCatalog(VlItemCatalogHeader *header){
+	size_t offset = CATALOG_ALIGN(sizeof(VlItemCatalogHeader));
+	for(int i = 0; i < CATALOG_ARRAY_COUNT; i++){
+		size_t count = (i == CATALOG_BITITEMS) ? header->bitItemCount : header->itemCount;
+		header->offsets[i] = offset;
+		offset = CATALOG_ALIGN(offset + elementSize[i] * count);
+	}
+	header->fileSize = offset;
+	return offset;
+}
+
+
+/**
+ * @brief Sets the array pointers of a catalog to the arrays of a catalog image
+ * @param catalog Catalog to bind
+ * @param base Start of the catalog image
+ */
+static void bindCatalog(VlItemCatalog *catalog, void *base){
+	char *bytes = base;
+	VlItemCatalogHeader *header = base;
+	catalog->header = header;
+	catalog->names = (void*) &bytes[header->offsets[CATALOG_NAME]];
+	catalog->addresses = (void*) &bytes[header->offsets[CATALOG_ADDRESS]];
+	catalog->lenTyps = (void*) &bytes[header->offsets[CATALOG_LENTYP]];
+	catalog->flags = (void*) &bytes[header->offsets[CATALOG_FLAGS]];
+	catalog->symbols = (void*) &bytes[header->offsets[CATALOG_SYMBOL]];
+	catalog->scaleFactors = (void*) &bytes[header->offsets[CATALOG_SCALEFACTOR]];
+	catalog->units = (void*) &bytes[header->offsets[CATALOG_UNIT]];
+	catalog->minVals = (void*) &bytes[header->offsets[CATALOG_MINVAL]];
+	catalog->maxVals = (void*) &bytes[header->offsets[CATALOG_MAXVAL]];
+	catalog->defaultValues = (void*) &bytes[header->offsets[CATALOG_DEFAULTVALUE]];
+	catalog->values = (void*) &bytes[header->offsets[CATALOG_VALUE]];
+	catalog->ciFields = (void*) &bytes[header->offsets[CATALOG_CIFIELD]];
+	catalog->ciKeys = (void*) &bytes[header->offsets[CATALOG_CIKEY]];
+	catalog->bitItemStart = (void*) &bytes[header->offsets[CATALOG_BITITEMSTART]];
+	catalog->bitItemCounts = (void*) &bytes[header->offsets[CATALOG_BITITEMCOUNT]];
+	catalog->bitItems = (void*) &bytes[header->offsets[CATALOG_BITITEMS]];
+}
+
+
+/**
+ * Builds the catalog image of the given items in one contiguous, allocated buffer.
+ *
+ * @param items Items to store in the catalog
+ * @param count Number of items
+ * @param fingerprint Fingerprint of the board and configuration, NULL if unknown
+ * @param image Pointer to store the allocated image, has to be freed by the caller
+ * @param size Pointer to store the size of the image
+ * @return 0 on success, 1 on failure
+ */
+int buildVlItemCatalog(VLItem *items, int count, BoardFingerprint *fingerprint, void **image, size_t *size){
+	VlItemCatalogHeader header = { 0 };
+	VlItemCatalog catalog;
+
+	header.magic = VLITEM_CATALOG_MAGIC;
+	header.version = VLITEM_CATALOG_VERSION;
+	header.itemCount = count;
+	header.bitItemSize = sizeof(BitItem);
+	if(fingerprint != NULL){
+		header.fingerprint = *fingerprint;
+	}
+	for(int i = 0; i < count; i++){
+		header.bitItemCount += items[i].BitItemCount > 0 ? items[i].BitItemCount : 0;
+	}
+	*size = layoutCatalog(&header);
+	*image = calloc(1, *size);
+	if(*image == NULL){
+		fprintf(stderr,"Memory allocation for the VLItem catalog failed\n");
+		return 1;
+	}
+	memcpy(*image, &header, sizeof(header));
+	bindCatalog(&catalog, *image);
+
+	uint32_t bitItemIndex = 0;
+	for(int i = 0; i < count; i++){
+		VLItem *item = &items[i];
+		memcpy(catalog.names[i], item->name, sizeof(item->name));
+		memcpy(catalog.addresses[i], item->Address, sizeof(item->Address));
+		memcpy(catalog.lenTyps[i], item->LenTyp, sizeof(item->LenTyp));
+		memcpy(catalog.flags[i], item->Flags, sizeof(item->Flags));
+		memcpy(catalog.symbols[i], item->Symbol, sizeof(item->Symbol));
+		memcpy(catalog.scaleFactors[i], item->ScaleFactor, sizeof(item->ScaleFactor));
+		memcpy(catalog.units[i], item->Unit, sizeof(item->Unit));
+		memcpy(catalog.minVals[i], item->MinVal, sizeof(item->MinVal));
+		memcpy(catalog.maxVals[i], item->MaxVal, sizeof(item->MaxVal));
+		memcpy(catalog.defaultValues[i], item->DefaultValue, sizeof(item->DefaultValue));
+		catalog.values[i] = item->Value;
+		memcpy(catalog.ciFields[i], item->CIField, sizeof(item->CIField));
+		memcpy(catalog.ciKeys[i], item->CIKey, sizeof(item->CIKey));
+
+		uint32_t bitItemCount = item->BitItemCount > 0 ? item->BitItemCount : 0;
+		catalog.bitItemStart[i] = bitItemIndex;
+		catalog.bitItemCounts[i] = bitItemCount;
+		if(bitItemCount > 0){
+			memcpy(&catalog.bitItems[bitItemIndex], item->BitItems, bitItemCount * sizeof(BitItem));
+		}
+		bitItemIndex += bitItemCount;
+	}
+	return 0;
+}
+
+
+/**
+ * Serialises the given items as catalog file into the directory of the axle.
+ *
+ * @param items Items to store in the catalog
+ * @param count Number of items
+ * @param fingerprint Fingerprint of the board and configuration, NULL if unknown
+ * @param fileName Name of the catalog file
+ * @return 0 on success, 1 on failure
+ */
+int writeVlItemCatalog(VLItem *items, int count, BoardFingerprint *fingerprint, char *fileName){
+	void *image;
+	size_t size;
+	FILE *file = NULL;
+
+	if(buildVlItemCatalog(items, count, fingerprint, &image, &size) == 1){
+		return 1;
+	}
+	if(createFileStream(&file, fileName, "wb", 0) == 1){
+		fprintf(stderr,"Error %s couldn't be opened\n",fileName);
+		free(image);
+		return 1;
+	}
+	size_t written = fwrite(image, 1, size, file);
+	closeFileStream(file, 0);
+	free(image);
+	if(written != size){
+		fprintf(stderr,"Error writing %s failed\n",fileName);
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * Parses vlItem.json once and writes all of its items into the catalog file.
+ *
+ * @param fileName Name of the catalog file
+ * @param fingerprint Fingerprint of the board and configuration vlItem.json was created from, NULL if unknown
+ * @return 0 on success, 1 on failure
+ */
+int createVlItemCatalogFromJson(char *fileName, BoardFingerprint *fingerprint){
+	int count = 0;
+	int error = 0;
+	VLItem *items = malloc(MAXSIZE * sizeof(VLItem));
+	if(items == NULL){
+		fprintf(stderr,"Memory allocation error\n");
+		return 1;
+	}
+	if(getVLItemsFromJson(items, MAXSIZE, &count) == 1){
+		error = 1;
+	}else{
+		error = writeVlItemCatalog(items, count, fingerprint, fileName);
+	}
+	for(int i = 0; i < count; i++){
+		free(items[i].BitItems);
+	}
+	free(items);
+	return error;
+}
+
+
+/**
+ * @brief Adds the modification time and size of a file to a stamp
+ * @param stamp Stamp to update
+ * @param path Path of the file
+ * @return 0 on success, 1 if the file doesn't exist
+ */
+static int addFileToStamp(uint64_t *stamp, char *path){
+	struct stat fileStat;
+	if(stat(path, &fileStat) != 0){
+		return 1;
+	}
+	uint64_t values[2] = { (uint64_t) fileStat.st_mtime, (uint64_t) fileStat.st_size };
+	for(int i = 0; i < 2; i++){
+		*stamp ^= values[i];
+		*stamp *= 1099511628211u;	// FNV-1a 64 bit prime
+	}
+	return 0;
+}
+
+
+/**
+ * Computes the stamp of the configuration files vlItem.json is created from, match.json of the axle and the
+ * shared Cl-Servos.ini. The stamp changes whenever one of the files is modified.
+ *
+ * @param stamp Pointer to store the stamp
+ * @return 0 on success, 1 if one of the files doesn't exist
+ */
+int getConfigStamp(uint64_t *stamp){
+	char path[256];
+	int error = 0;
+
+	*stamp = 14695981039346656037u;	// FNV-1a 64 bit offset basis
+	sprintf(path, "./axle_%d/match.json",axleNum);
+	error |= addFileToStamp(stamp, path);
+	error |= addFileToStamp(stamp, "./shared/Cl-Servos.ini");
+	return error;
+}
+
+
+/**
+ * Checks whether an open catalog was created from the given board item table and configuration.
+ *
+ * @param catalog Open catalog
+ * @param fingerprint Fingerprint of the connected board and the current configuration
+ * @return 1 if the catalog matches, 0 otherwise
+ */
+int matchesVlItemCatalog(VlItemCatalog *catalog, BoardFingerprint *fingerprint){
+	BoardFingerprint *stored = &catalog->header->fingerprint;
+	return stored->itemCount == fingerprint->itemCount
+			&& stored->tableChecksum == fingerprint->tableChecksum
+			&& stored->configStamp == fingerprint->configStamp;
+}
+
+
+/**
+ * Checks whether the catalog file has to be rebuilt because it is missing or older than its source file.
+ *
+ * @param fileName Name of the catalog file
+ * @param sourceName Name of the file the catalog was built from, e.g. vlItem.json
+ * @return 1 if the catalog is outdated, 0 if it is up to date
+ */
+int isVlItemCatalogOutdated(char *fileName, char *sourceName){
+	char path[256];
+	struct stat catalogStat;
+	struct stat sourceStat;
+
+	sprintf(path, "./axle_%d/%s",axleNum,fileName);
+	if(stat(path, &catalogStat) != 0){
+		return 1;
+	}
+	sprintf(path, "./axle_%d/%s",axleNum,sourceName);
+	if(stat(path, &sourceStat) != 0){
+		return 0;
+	}
+#ifdef _WIN32
+	// written within the same second counts as outdated, the timestamps only have a resolution of seconds here
+	return sourceStat.st_mtime >= catalogStat.st_mtime;
+#else
+	// the catalog is written right after vlItem.json, often within the same second
+	return sourceStat.st_mtim.tv_sec > catalogStat.st_mtim.tv_sec
+			|| (sourceStat.st_mtim.tv_sec == catalogStat.st_mtim.tv_sec
+					&& sourceStat.st_mtim.tv_nsec >= catalogStat.st_mtim.tv_nsec);
+#endif
+}
+
+
+/**
+ * @brief Checks that a mapped file is a complete catalog of this version
+ * @param base Start of the mapped file
+ * @param size Size of the mapped file
+ * @return 0 if the catalog is valid, 1 otherwise
+ */
+static int validateCatalog(void *base, size_t size){
+	VlItemCatalogHeader expected;
+	VlItemCatalogHeader *header = base;
+	VlItemCatalog catalog;
+
+	if(size < sizeof(VlItemCatalogHeader) || header->magic != VLITEM_CATALOG_MAGIC
+			|| header->version != VLITEM_CATALOG_VERSION || header->bitItemSize != sizeof(BitItem)){
+		return 1;
+	}
+	memcpy(&expected, header, sizeof(expected));
+	if(layoutCatalog(&expected) != size || memcmp(&expected, header, sizeof(expected)) != 0){
+		return 1;
+	}
+	bindCatalog(&catalog, base);
+	for(uint32_t i = 0; i < header->itemCount; i++){
+		if(catalog.bitItemStart[i] + catalog.bitItemCounts[i] > header->bitItemCount){
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * Maps the catalog file of the axle into memory. The mapping is copy on write, the file stays unchanged.
+ *
+ * @param catalog Catalog to open
+ * @param fileName Name of the catalog file
+ * @return 0 on success, 1 if the file is missing, can't be mapped or isn't a valid catalog of this version
+ */
+int openVlItemCatalog(VlItemCatalog *catalog, char *fileName){
+	char path[256];
+	void *base;
+	size_t size;
+
+	sprintf(path, "./axle_%d/%s",axleNum,fileName);
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE){
+		return 1;
+	}
+	size = GetFileSize(file, NULL);
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if(mapping == NULL){
+		return 1;
+	}
+	base = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if(base == NULL){
+		return 1;
+	}
+#else
+	struct stat fileStat;
+	int file = open(path, O_RDONLY);
+	if(file == -1){
+		return 1;
+	}
+	if(fstat(file, &fileStat) == -1 || fileStat.st_size == 0){
+		close(file);
+		return 1;
+	}
+	size = fileStat.st_size;
+	base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+	close(file);
+	if(base == MAP_FAILED){
+		return 1;
+	}
+#endif
+	catalog->base = base;
+	catalog->size = size;
+	if(validateCatalog(base, size) == 1){
+		fprintf(stderr,"%s is no valid VLItem catalog of version %d\n",fileName,VLITEM_CATALOG_VERSION);
+		closeVlItemCatalog(catalog);
+		return 1;
+	}
+	bindCatalog(catalog, base);
+	return 0;
+}
+
+
+/**
+ * @brief Unmaps a catalog, items and bit items taken from it are invalid afterwards
+ * @param catalog Catalog to close
+ */
+void closeVlItemCatalog(VlItemCatalog *catalog){
+	if(catalog->base == NULL){
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(catalog->base);
+#else
+	munmap(catalog->base, catalog->size);
+#endif
+	catalog->base = NULL;
+	catalog->header = NULL;
+	catalog->size = 0;
+}
+
+
+/**
+ * Fills a VLItem with the item at the given position of the catalog. The bit items are not copied, the
+ * item refers to the bit items of the catalog, which stay valid as long as the catalog is open.
+ *
+ * @param catalog Open catalog
+ * @param i Position of the item
+ * @param item VLItem to fill
+ * @return 0 on success, 1 if the position is out of range
+ */
+int getVlItemFromCatalog(VlItemCatalog *catalog, int i, VLItem *item){
+	if(catalog->header == NULL || i < 0 || (uint32_t) i >= catalog->header->itemCount){
+		return 1;
+	}
+	memcpy(item->name, catalog->names[i], sizeof(item->name));
+	memcpy(item->Address, catalog->addresses[i], sizeof(item->Address));
+	memcpy(item->LenTyp, catalog->lenTyps[i], sizeof(item->LenTyp));
+	memcpy(item->Flags, catalog->flags[i], sizeof(item->Flags));
+	memcpy(item->Symbol, catalog->symbols[i], sizeof(item->Symbol));
+	memcpy(item->ScaleFactor, catalog->scaleFactors[i], sizeof(item->ScaleFactor));
+	memcpy(item->Unit, catalog->units[i], sizeof(item->Unit));
+	memcpy(item->MinVal, catalog->minVals[i], sizeof(item->MinVal));
+	memcpy(item->MaxVal, catalog->maxVals[i], sizeof(item->MaxVal));
+	memcpy(item->DefaultValue, catalog->defaultValues[i], sizeof(item->DefaultValue));
+	item->Value = catalog->values[i];
+	memcpy(item->CIField, catalog->ciFields[i], sizeof(item->CIField));
+	memcpy(item->CIKey, catalog->ciKeys[i], sizeof(item->CIKey));
+	item->BitItemCount = catalog->bitItemCounts[i];
+	item->BitItems = item->BitItemCount > 0 ? &catalog->bitItems[catalog->bitItemStart[i]] : NULL;
+	return 0;
+}
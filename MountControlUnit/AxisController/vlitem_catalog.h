@@ -0,0 +1,94 @@
+/*
+ * vlitem_catalog.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef VLITEM_CATALOG_H_
+#define VLITEM_CATALOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "json_utils.h"
+
+#define VLITEM_CATALOG_FILE "vlItem.bin"
+#define VLITEM_CATALOG_MAGIC 0x43494C56	// "VLIC"
+#define VLITEM_CATALOG_VERSION 2
+
+// Arrays of the catalog, every field of the VLItems is stored as one contiguous array
+enum
+{
+	CATALOG_NAME,
+	CATALOG_ADDRESS,
+	CATALOG_LENTYP,
+	CATALOG_FLAGS,
+	CATALOG_SYMBOL,
+	CATALOG_SCALEFACTOR,
+	CATALOG_UNIT,
+	CATALOG_MINVAL,
+	CATALOG_MAXVAL,
+	CATALOG_DEFAULTVALUE,
+	CATALOG_VALUE,
+	CATALOG_CIFIELD,
+	CATALOG_CIKEY,
+	CATALOG_BITITEMSTART,
+	CATALOG_BITITEMCOUNT,
+	CATALOG_BITITEMS,
+	CATALOG_ARRAY_COUNT
+};
+
+// Identifies the board item table and the configuration a catalog was created from
+typedef struct
+{
+	uint32_t itemCount;
+	uint32_t tableChecksum;		// CRC-32 over the describe replies of all board items
+	uint64_t configStamp;		// modification times and sizes of match.json and Cl-Servos.ini
+} BoardFingerprint;
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t fileSize;
+	uint32_t itemCount;
+	uint32_t bitItemCount;
+	uint32_t bitItemSize;		// sizeof(BitItem) of the writer, guards against layout changes
+	BoardFingerprint fingerprint;
+	uint32_t offsets[CATALOG_ARRAY_COUNT];	// offset of every array from the start of the file
+} VlItemCatalogHeader;
+
+typedef struct
+{
+	VlItemCatalogHeader *header;
+	char (*names)[35];
+	char (*addresses)[3];
+	char (*lenTyps)[2];
+	char (*flags)[2];
+	char (*symbols)[10];
+	char (*scaleFactors)[4];
+	char (*units)[6];
+	char (*minVals)[4];
+	char (*maxVals)[4];
+	char (*defaultValues)[4];
+	double *values;
+	char (*ciFields)[256];
+	char (*ciKeys)[256];
+	uint32_t *bitItemStart;		// index of the first bit item of every item in bitItems
+	uint32_t *bitItemCounts;
+	BitItem *bitItems;
+	void *base;					// mapped file
+	size_t size;
+} VlItemCatalog;
+
+int buildVlItemCatalog(VLItem *items, int count, BoardFingerprint *fingerprint, void **image, size_t *size);
+int writeVlItemCatalog(VLItem *items, int count, BoardFingerprint *fingerprint, char *fileName);
+int createVlItemCatalogFromJson(char *fileName, BoardFingerprint *fingerprint);
+int getConfigStamp(uint64_t *stamp);
+int matchesVlItemCatalog(VlItemCatalog *catalog, BoardFingerprint *fingerprint);
+int isVlItemCatalogOutdated(char *fileName, char *sourceName);
+int openVlItemCatalog(VlItemCatalog *catalog, char *fileName);
+void closeVlItemCatalog(VlItemCatalog *catalog);
+int getVlItemFromCatalog(VlItemCatalog *catalog, int i, VLItem *item);
+
+#endif /* VLITEM_CATALOG_H_ */
@@ -1,52 +1,89 @@
 #include "vlitem_handler.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-// Function to add a VLItem to the array
-int addVlItemToArray(VLItem item, VLItem array[]) {
-    // Check if the item is already in the array
-    for (int i = 0; i < MAXSIZE; i++) {
-        if (strcmp(array[i].name, item.name) == 0) {
-            // Item already exists in the array, return an error code
-            return -2; // Duplicate item
-        }
+// FNV-1a hash of an item name
+static uint32_t hashItemName(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name != '\0') {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
     }
+    return hash;
+}
 
-    // If the item is not in the array, find an empty slot to add it
-    for (int i = 0; i < MAXSIZE; i++) {
-        if (array[i].name[0] == '\0') {
-            // Found an empty slot in the array, add the item here
-        	memcpy(&(array[i]),&item,sizeof(VLItem));
-            return 0; // Success
+// Function to find the index slot of an item name, returns the slot holding the item or the empty slot to insert it
+static int findSlot(VlItemCache *cache, const char *item_name) {
+    int slot = hashItemName(item_name) & (HASHSIZE - 1);
+    while (cache->index[slot] != 0) {
+        if (strcmp(cache->items[cache->index[slot] - 1].name, item_name) == 0) {
+            return slot;
         }
+        slot = (slot + 1) & (HASHSIZE - 1);
     }
+    return slot;
+}
 
-    // If the array is full, return an error code (you may want to handle this case differently)
-    return -1; // Array is full
+// Function to initialise an empty cache, a zero initialised cache is empty as well
+void initVlItemCache(VlItemCache *cache) {
+    memset(cache->index, 0, sizeof(cache->index));
+    cache->count = 0;
 }
 
-// Function to get a VLItem by name from the array
-VLItem* getVlItemFromArray(char *item_name, VLItem array[]) {
-    for (int i = 0; i < MAXSIZE; i++) {
-        if (strcmp(array[i].name, item_name) == 0) {
-            // Found the item with the matching name, return a pointer to it
-            return &array[i];
-        }
+// Function to add a VLItem to the cache, the item is copied and stays at a stable address afterwards
+int addVlItemToCache(VlItemCache *cache, VLItem *item) {
+    int slot = findSlot(cache, item->name);
+    if (cache->index[slot] != 0) {
+        return -2; // Duplicate item
+    }
+    if (cache->count == MAXSIZE) {
+        return -1; // Cache is full
+    }
+    memcpy(&(cache->items[cache->count]), item, sizeof(VLItem));
+    cache->index[slot] = ++cache->count;
+    return 0; // Success
+}
 
+// Function to get a VLItem by name from the cache
+VLItem* getVlItemFromCache(VlItemCache *cache, const char *item_name) {
+    int slot = findSlot(cache, item_name);
+    if (cache->index[slot] == 0) {
+        return NULL;
     }
-    // If the item is not found, return NULL (you may want to handle this case differently)
-    return NULL;
+    return &(cache->items[cache->index[slot] - 1]);
 }
 
-int getBitItemFromVlItem(VLItem item, const char *bitItemName, BitItem **bitItem) {
-    for (int i = 0; i < item.BitItemCount; i++) {
-        if (strcmp(item.BitItems[i].bitName, bitItemName) == 0) {
-            *bitItem = &(item.BitItems[i]);
+// Function to get the position of a cached item, -1 if the item isn't part of the cache
+int getVlItemIndex(VlItemCache *cache, const VLItem *item) {
+    if (item < cache->items || item >= cache->items + cache->count) {
+        return -1;
+    }
+    return (int)(item - cache->items);
+}
+
+// Function to fill the cache with all items of an open catalog, the bit items refer to the catalog
+int loadVlItemCache(VlItemCache *cache, VlItemCatalog *catalog) {
+    VLItem item;
+    initVlItemCache(cache);
+    for (uint32_t i = 0; i < catalog->header->itemCount; i++) {
+        getVlItemFromCatalog(catalog, i, &item);
+        if (addVlItemToCache(cache, &item) == -1) {
+            fprintf(stderr, "VLItem cache is full, %u items not cached\n", catalog->header->itemCount - i);
+            break;
+        }
+    }
+    return 0;
+}
+
+int getBitItemFromVlItem(VLItem *item, const char *bitItemName, BitItem **bitItem) {
+    for (int i = 0; i < item->BitItemCount; i++) {
+        if (strcmp(item->BitItems[i].bitName, bitItemName) == 0) {
+            *bitItem = &(item->BitItems[i]);
             return 0;
         }
     }
 
-    fprintf(stderr, "BitItem: %s not found in VLItem %s", bitItemName, item.name);
+    fprintf(stderr, "BitItem: %s not found in VLItem %s", bitItemName, item->name);
     return 1;
 }
-
@@ -8,11 +8,24 @@
 #ifndef VLITEM_HANDLER_H_
 #define VLITEM_HANDLER_H_
 
+#include <stdint.h>
 #include "json_utils.h"
+#include "vlitem_catalog.h"
 #define MAXSIZE (256)
+#define HASHSIZE (2*MAXSIZE)	// power of two, keeps the load factor of the index below 0.5
 
-int addVlItemToArray(VLItem item,VLItem array[]);
-VLItem* getVlItemFromArray(char *item_name, VLItem array[]);
-int getBitItemFromVlItem(VLItem item, const char *bitItemName, BitItem **bitItem);
+typedef struct
+{
+	VLItem items[MAXSIZE];
+	int16_t index[HASHSIZE];	// open addressing table, position of the item in items + 1 or 0 for empty slots
+	int count;
+} VlItemCache;
 
-#endif /* SOCKET_UTILS_H_ */
+void initVlItemCache(VlItemCache *cache);
+int addVlItemToCache(VlItemCache *cache, VLItem *item);
+VLItem* getVlItemFromCache(VlItemCache *cache, const char *item_name);
+int getVlItemIndex(VlItemCache *cache, const VLItem *item);
+int loadVlItemCache(VlItemCache *cache, VlItemCatalog *catalog);
+int getBitItemFromVlItem(VLItem *item, const char *bitItemName, BitItem **bitItem);
+
+#endif /* VLITEM_HANDLER_H_ */
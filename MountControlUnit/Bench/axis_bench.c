@@ -0,0 +1,477 @@
+/**
+ * @file axis_bench.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Microbenchmarks of the transport and catalog hot paths of the AxisController
+ *
+ * @details Measures the frame encoding, the checksum check of recv_dataf, the payload extraction of describe
+ *	replies, the VLItem lookup, writeToBoard, logz and the precise sleep, and the reads and writes over TCP
+ *	against a loopback responder. The responder runs the simulated board of sim_board.c in a second thread, so the end-to-end
+ *	results contain the complete client path and the loopback round trip, but no board latency.
+ *	Every benchmark is repeated with doubled iterations until it ran for at least BENCH_MIN_TIME_NS and
+ *	reports the time and the heap allocations per operation. Allocations are counted by wrapping malloc,
+ *	calloc and realloc at link time, only on the benchmarking thread. Without the GNU linker the column shows "-".
+ *	The reads, writes and lookups of the control loop must not allocate, the bench exits with an error if they do.
+ *	The VLItems are written into the catalog ./axle_1/vlItem.bin and loaded like on a board start.
+ *	Usage: axis_bench [filter], only benchmarks containing the filter in their name are run
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "sockets.h"
+#include "socket_utils.h"
+#include "vlitem_handler.h"
+#include "item_handle.h"
+#include "comm_stats.h"
+#include "common_utils.h"
+#include "thread_utils.h"
+#include "logz.h"
+#include "sim_board.h"
+
+#define BENCH_MIN_TIME_NS 200000000ULL	// shortest measurement of a benchmark
+#define BENCH_MAX_ITERATIONS (1ULL << 30)
+#define BENCH_READ_COUNT 8				// items of the pipelined reads
+#define BENCH_FINGERPRINT 0x42454E43	// "BENC", table checksum of the benchmark catalog
+
+#ifdef BENCH_WRAP_MALLOC
+// heap allocations of the calling thread, counted by the wrappers of --wrap=malloc,calloc,realloc
+static __thread uint64_t allocations;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void *pointer, size_t size);
+
+void* __wrap_malloc(size_t size){
+	allocations++;
+	return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size){
+	allocations++;
+	return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void *pointer, size_t size){
+	allocations++;
+	return __real_realloc(pointer, size);
+}
+#endif
+
+typedef struct
+{
+	BoardConnection connection;					// client connection to the loopback responder
+	unsigned char reply[SIM_MAX_REPLY];			// valid describe reply
+	int replySize;
+	ItemHandle *handles[BENCH_READ_COUNT];
+	BoardRead reads[BENCH_READ_COUNT];
+	volatile uint32_t sink;						// keeps the results of the pure computations alive
+} BenchContext;
+
+typedef struct
+{
+	const char *name;
+	void (*run)(BenchContext *context, uint64_t iterations);
+	int allocationFree;		// hot path of the control loop, the benchmark fails if it allocates
+} Benchmark;
+
+typedef struct
+{
+	SimBoard board;
+	SOCKET server;
+	int port;
+	pthread_t thread;
+} BenchResponder;
+
+// items of the pipelined reads, plain items and a bit item
+static char *readNames[BENCH_READ_COUNT] = { "pos_2", "vel_targ_2", "state_2.run", "sysid_index", "sysid_amp",
+		"sysid_phase", "sysid_freq", "peripherial" };
+
+static BitItem stateBits[] = {
+	{ .bitName = "run", .startBit = 0, .size = 1 },
+	{ .bitName = "motionmode", .startBit = 1, .size = 2 },
+	{ .bitName = "fault", .startBit = 3, .size = 1 },
+};
+
+
+/**
+ * @brief Fills a VLItem of the benchmark catalog
+ * @param item Item to fill
+ * @param name Name of the item
+ * @param address RAM address of the item on the board
+ * @param lenTyp Length type, 8: int16, 9: uint16, 10: int32, 11: uint32, 12: float
+ * @param bitItems Bit items of the item, NULL for plain items
+ * @param bitItemCount Number of bit items
+ */
+static void setBenchItem(VLItem *item, const char *name, uint32_t address, char lenTyp, BitItem *bitItems,
+		int bitItemCount){
+	memset(item, 0, sizeof(VLItem));
+	strncpy(item->name, name, sizeof(item->name) - 1);
+	item->Address[0] = address & 0xFF;
+	item->Address[1] = (address >> 8) & 0xFF;
+	item->Address[2] = (address >> 16) & 0xFF;
+	item->LenTyp[0] = lenTyp;
+	item->BitItems = bitItems;
+	item->BitItemCount = bitItemCount;
+}
+
+
+/**
+ * @brief Writes the VLItems of the benchmark into the catalog of the axle and loads them into the VLItem cache
+ * @param connection Connection the items are loaded into
+ * @return 0 on success, 1 otherwise
+ */
+static int setupCatalog(BoardConnection *connection){
+	VLItem vlItems[10];
+	char directory[32];
+
+	setBenchItem(&vlItems[0], "pos_2", 0x100, 10, NULL, 0);
+	setBenchItem(&vlItems[1], "vel_targ_2", 0x104, 12, NULL, 0);
+	setBenchItem(&vlItems[2], "state_2", 0x108, 11, stateBits, sizeof(stateBits) / sizeof(stateBits[0]));
+	setBenchItem(&vlItems[3], "sysid_index", 0x10C, 11, NULL, 0);
+	setBenchItem(&vlItems[4], "sysid_amp", 0x110, 12, NULL, 0);
+	setBenchItem(&vlItems[5], "sysid_phase", 0x114, 12, NULL, 0);
+	setBenchItem(&vlItems[6], "sysid_freq", 0x118, 12, NULL, 0);
+	setBenchItem(&vlItems[7], "peripherial", 0x11C, 9, NULL, 0);
+	setBenchItem(&vlItems[8], "vel_lim_2", 0x120, 12, NULL, 0);
+	setBenchItem(&vlItems[9], "acc_lim_2", 0x124, 12, NULL, 0);
+
+	sprintf(directory,"axle_%d",axleNum);
+	createDirectory(directory);
+	BoardFingerprint fingerprint = { 10, BENCH_FINGERPRINT, 0 };
+	if(writeVlItemCatalog(vlItems, 10, &fingerprint, VLITEM_CATALOG_FILE) == 1
+			|| openBoardCatalog(connection, &fingerprint) == 1){
+		fprintf(stderr,"Benchmark catalog couldn't be created\n");
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Answers the frames of the benchmark client with the simulated board until the connection is closed
+ * @param arg Responder
+ */
+static void* runResponder(void *arg){
+	BenchResponder *responder = arg;
+	unsigned char frame[SIM_FRAME_SIZE];
+	unsigned char reply[SIM_MAX_REPLY];
+	int enable = 1;
+
+	SOCKET client = accept(responder->server, NULL, NULL);
+	if(client == INVALID_SOCKET){
+		return NULL;
+	}
+	setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (char*) &enable, sizeof(enable));
+	while(1){
+		int received = 0;
+		while(received < SIM_FRAME_SIZE){
+			int bytesRead = recv(client, (char*) &frame[received], SIM_FRAME_SIZE - received, 0);
+			if(bytesRead <= 0){
+				closesocket(client);
+				return NULL;
+			}
+			received += bytesRead;
+		}
+		size_t size = handleSimFrame(&responder->board, frame, reply);
+		size_t sent = 0;
+		while(sent < size){
+			int bytesSent = send(client, (char*) &reply[sent], size - sent, 0);
+			if(bytesSent <= 0){
+				closesocket(client);
+				return NULL;
+			}
+			sent += bytesSent;
+		}
+	}
+}
+
+
+/**
+ * @brief Starts the loopback responder on a free port of 127.0.0.1
+ * @param responder Responder to start
+ * @return 0 on success, 1 otherwise
+ */
+static int startResponder(BenchResponder *responder){
+	struct sockaddr_in address;
+	socklen_t addressLength = sizeof(address);
+
+	if(initSimBoard(&responder->board) == 1){
+		return 1;
+	}
+	responder->server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if(responder->server == INVALID_SOCKET){
+		fprintf(stderr,"Responder socket couldn't be created\n");
+		return 1;
+	}
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = 0;
+	if(bind(responder->server, (struct sockaddr*) &address, sizeof(address)) != 0
+			|| listen(responder->server, 1) != 0
+			|| getsockname(responder->server, (struct sockaddr*) &address, &addressLength) != 0){
+		fprintf(stderr,"Responder socket couldn't be bound\n");
+		closesocket(responder->server);
+		return 1;
+	}
+	responder->port = ntohs(address.sin_port);
+	if(pthread_create(&responder->thread, NULL, runResponder, responder) != 0){
+		fprintf(stderr,"Responder thread couldn't be started\n");
+		closesocket(responder->server);
+		return 1;
+	}
+	return 0;
+}
+
+
+static void stopResponder(BenchResponder *responder){
+	pthread_join(responder->thread, NULL);
+	closesocket(responder->server);
+	freeSimBoard(&responder->board);
+}
+
+
+static void benchEncode(BenchContext *context, uint64_t iterations){
+	unsigned char readRam[] = { 5, 4, 0x00, 0x01, 0x00, 4 };
+	unsigned char frame[16];
+	for(uint64_t i = 0; i < iterations; i++){
+		readRam[2] = (unsigned char) i;
+		encode(frame, readRam);
+		context->sink += frame[6];
+	}
+}
+
+
+static void benchReplyChecksum(BenchContext *context, uint64_t iterations){
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += checkReplyChecksum((char*) context->reply, context->replySize);
+	}
+}
+
+
+static void benchExtractInformation(BenchContext *context, uint64_t iterations){
+	char buffer[SIM_MAX_REPLY];
+	for(uint64_t i = 0; i < iterations; i++){
+		memcpy(buffer, context->reply, context->replySize);
+		extractInformationFromData(buffer, SIM_DESCRIBE_SIZE);
+		context->sink += buffer[i % SIM_DESCRIBE_SIZE];
+	}
+}
+
+
+static void benchGetVLItemHit(BenchContext *context, uint64_t iterations){
+	VLItem *item;
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += getVLItem(&context->connection, &item, "sysid_phase");
+	}
+}
+
+
+// the lookup only, getVLItem additionally reports every miss on stderr
+static void benchGetVLItemMiss(BenchContext *context, uint64_t iterations){
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += getVlItemFromCache(&context->connection.items, "sysid_gain") == NULL;
+	}
+}
+
+
+static void benchLogz(BenchContext *context, uint64_t iterations){
+	(void) context;
+	for(uint64_t i = 0; i < iterations; i++){
+		logz("Board Write Operation : Item 'sysid_index' , Value= 42");
+	}
+}
+
+
+static void benchWriteToBoardPlain(BenchContext *context, uint64_t iterations){
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += writeToBoard(&context->connection, "sysid_index", (uint32_t) i);
+	}
+}
+
+
+static void benchWriteToBoardBit(BenchContext *context, uint64_t iterations){
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += writeToBoard(&context->connection, "state_2.run", i & 1);
+	}
+}
+
+
+// repeated run bit like startMotor sends it, suppressed while the shadow word is recent
+static void benchWriteToBoardBitUnchanged(BenchContext *context, uint64_t iterations){
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += writeToBoard(&context->connection, "state_2.run", 1);
+	}
+}
+
+
+// velocity setpoints like the motion loops send them
+static void benchWriteToBoardFloat(BenchContext *context, uint64_t iterations){
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += writeToBoardFloat(&context->connection, "vel_targ_2", (float) (i & 0xFF) * 0.001f);
+	}
+}
+
+
+static void benchReadFromBoard(BenchContext *context, uint64_t iterations){
+	uint32_t value;
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += readFromBoardUInt32(&context->connection, "sysid_index", &value);
+	}
+}
+
+
+static void benchReadFromBoardMany(BenchContext *context, uint64_t iterations){
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += readFromBoardMany(&context->connection, context->reads, BENCH_READ_COUNT);
+	}
+}
+
+
+static void benchReadItem(BenchContext *context, uint64_t iterations){
+	uint32_t value;
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += readItem(&context->connection, context->handles[3], &value);
+	}
+}
+
+
+static void benchReadItemMany(BenchContext *context, uint64_t iterations){
+	uint32_t values[BENCH_READ_COUNT];
+	for(uint64_t i = 0; i < iterations; i++){
+		context->sink += readItemMany(&context->connection, context->handles, values, NULL, BENCH_READ_COUNT);
+	}
+}
+
+
+// the time per operation above 1000000 ns is the late wakeup of the precise sleep
+static void benchSleep(BenchContext *context, uint64_t iterations){
+	(void) context;
+	for(uint64_t i = 0; i < iterations; i++){
+		sleep_us(1000);
+	}
+}
+
+
+static Benchmark benchmarks[] = {
+	{ "encode", benchEncode, 1 },
+	{ "checkReplyChecksum/80", benchReplyChecksum, 1 },
+	{ "extractInformationFromData/70", benchExtractInformation, 1 },
+	{ "getVLItem/hit", benchGetVLItemHit, 1 },
+	{ "getVLItem/miss", benchGetVLItemMiss, 1 },
+	{ "logz", benchLogz, 0 },
+	{ "sleep_us/1000", benchSleep, 1 },
+	{ "loopback/writeToBoard/plain", benchWriteToBoardPlain, 1 },
+	{ "loopback/writeToBoard/bit", benchWriteToBoardBit, 1 },
+	{ "loopback/writeToBoard/bitSame", benchWriteToBoardBitUnchanged, 1 },
+	{ "loopback/writeToBoardFloat", benchWriteToBoardFloat, 1 },
+	{ "loopback/readFromBoardUInt32", benchReadFromBoard, 1 },
+	{ "loopback/readFromBoardMany/8", benchReadFromBoardMany, 1 },
+	{ "loopback/readItem", benchReadItem, 1 },
+	{ "loopback/readItemMany/8", benchReadItemMany, 1 },
+};
+
+
+/**
+ * @brief Runs a benchmark with doubled iterations until it took BENCH_MIN_TIME_NS and prints the result
+ * @param benchmark Benchmark to run
+ * @param context Shared state of the benchmarks
+ * @return 0 on success, 1 if an allocation free benchmark allocated
+ */
+static int runBenchmark(Benchmark *benchmark, BenchContext *context){
+	uint64_t iterations = 1;
+	uint64_t elapsed;
+	uint64_t allocated = 0;
+
+	benchmark->run(context, 1);
+	while(1){
+#ifdef BENCH_WRAP_MALLOC
+		uint64_t allocationsBefore = allocations;
+#endif
+		uint64_t start = monotonicNs();
+		benchmark->run(context, iterations);
+		elapsed = monotonicNs() - start;
+#ifdef BENCH_WRAP_MALLOC
+		allocated = allocations - allocationsBefore;
+#endif
+		if(elapsed >= BENCH_MIN_TIME_NS || iterations >= BENCH_MAX_ITERATIONS){
+			break;
+		}
+		iterations *= 2;
+	}
+#ifdef BENCH_WRAP_MALLOC
+	printf("%-32s %12" PRIu64 " %12.1f %10.2f\n", benchmark->name, iterations, (double) elapsed / iterations,
+			(double) allocated / iterations);
+#else
+	(void) allocated;
+	printf("%-32s %12" PRIu64 " %12.1f %10s\n", benchmark->name, iterations, (double) elapsed / iterations, "-");
+#endif
+	fflush(stdout);
+	if(benchmark->allocationFree && allocated > 0){
+		fprintf(stderr,"ERROR: %s allocated %" PRIu64 " times in %" PRIu64 " iterations\n", benchmark->name,
+				allocated, iterations);
+		return 1;
+	}
+	return 0;
+}
+
+
+int main(int argc, char *argv[]){
+	BenchContext context;
+	BenchResponder responder;
+	char *filter = argc > 1 ? argv[1] : "";
+	int failed = 0;
+
+	memset(&context, 0, sizeof(context));
+	initBoardConnection(&context.connection);
+	axleNum = 1;
+	initLogger("bench.txt");
+	if(socketsStartup() != 0){
+		fprintf(stderr,"Sockets couldn't be initialised\n");
+		return EXIT_FAILURE;
+	}
+	if(setupCatalog(&context.connection) == 1 || startResponder(&responder) == 1){
+		return EXIT_FAILURE;
+	}
+	if(createConnection(&context.connection, "127.0.0.1", responder.port) == 1){
+		return EXIT_FAILURE;
+	}
+
+	// an empty describe reply of the simulated board is checked and extracted like a reply of getBoardItem
+	unsigned char describe[] = { 5, 2, 0 };
+	unsigned char frame[16];
+	encode(frame, describe);
+	context.replySize = handleSimFrame(&responder.board, frame, context.reply);
+
+	for(int i = 0; i < BENCH_READ_COUNT; i++){
+		context.reads[i].name = readNames[i];
+		if(resolveItem(&context.connection, readNames[i], &context.handles[i]) == 1){
+			fprintf(stderr,"Item %s couldn't be resolved\n",readNames[i]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("%-32s %12s %12s %10s\n", "benchmark", "iterations", "ns/op", "allocs/op");
+	for(size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++){
+		if(strstr(benchmarks[i].name, filter) != NULL){
+			failed |= runBenchmark(&benchmarks[i], &context);
+		}
+	}
+	printf("\nLoopback transactions:\n");
+	dumpCommStats(&context.connection.stats, stdout);
+
+	for(int i = 0; i < BENCH_READ_COUNT; i++){
+		releaseItem(context.handles[i]);
+	}
+	closeBoardConnection(&context.connection);
+	stopResponder(&responder);
+	closeLogger();
+	socketsShutdown();
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
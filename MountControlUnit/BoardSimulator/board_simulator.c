@@ -0,0 +1,252 @@
+/**
+ * @file board_simulator.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief TCP server simulating the ASA Board
+ *
+ * @details Accepts one AxisController connection at a time and answers its frames with the simulated board of
+ *	sim_board.c. Every reply can be delayed by a fixed latency plus a random jitter, and a share of the replies
+ *	can be corrupted by flipping a single bit, which makes the checksum check of the client fail. With a fixed
+ *	seed the injected jitter and corruption are reproducible.
+ *	If the item table describes axes, the simulated axes move while a client is connected, and their loop rate
+ *	and overshoot are printed when the client disconnects.
+ *	Usage: board_simulator [-p port] [-c items.json] [-l latency_us] [-j jitter_us] [-e corruption_rate] [-s seed]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+typedef int socklen_t;
+#else
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#define SOCKET int
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+#include "sim_board.h"
+#include "sim_axis.h"
+
+#define DEFAULT_PORT 1000
+#define DEFAULT_ITEM_TABLE "sim_items.json"
+
+typedef struct
+{
+	int port;
+	char *itemTable;
+	long latency;		// fixed delay of every reply in us
+	long jitter;		// maximum random delay added to the latency in us
+	double corruption;	// share of corrupted replies between 0 and 1
+	unsigned int seed;
+} SimOptions;
+
+
+/**
+ * @brief Monotonic time in seconds, the time base of the axis model
+ */
+static double getSimTime(){
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+
+static void sleepMicroseconds(long microseconds){
+	if(microseconds <= 0){
+		return;
+	}
+#ifdef _WIN32
+	Sleep((microseconds + 999) / 1000);
+#else
+	struct timespec delay = { microseconds / 1000000, (microseconds % 1000000) * 1000 };
+	nanosleep(&delay, NULL);
+#endif
+}
+
+
+/**
+ * @brief Parses the command line
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param options Destination of the options, holds the defaults on entry
+ * @return 0 on success, 1 on an unknown or incomplete option
+ */
+static int parseOptions(int argc, char *argv[], SimOptions *options){
+	for(int i = 1; i < argc; i++){
+		if(i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2){
+			return 1;
+		}
+		char *value = argv[++i];
+		switch(argv[i - 1][1]){
+		case 'p':
+			options->port = atoi(value);
+			break;
+		case 'c':
+			options->itemTable = value;
+			break;
+		case 'l':
+			options->latency = atol(value);
+			break;
+		case 'j':
+			options->jitter = atol(value);
+			break;
+		case 'e':
+			options->corruption = atof(value);
+			break;
+		case 's':
+			options->seed = (unsigned int)strtoul(value, NULL, 10);
+			break;
+		default:
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Receives exactly one frame
+ * @param client Connected client
+ * @param frame Destination of SIM_FRAME_SIZE bytes
+ * @return 0 on success, 1 if the connection was closed
+ */
+static int receiveFrame(SOCKET client, unsigned char *frame){
+	int received = 0;
+	while(received < SIM_FRAME_SIZE){
+		int bytesRead = recv(client, (char*) &frame[received], SIM_FRAME_SIZE - received, 0);
+		if(bytesRead <= 0){
+			return 1;
+		}
+		received += bytesRead;
+	}
+	return 0;
+}
+
+
+/**
+ * Answers the frames of a client until it closes the connection.
+ *
+ * @param board Simulated board
+ * @param dynamics Axis model of the board
+ * @param client Connected client
+ * @param options Injected latency, jitter and corruption
+ */
+static void serveClient(SimBoard *board, SimDynamics *dynamics, SOCKET client, SimOptions *options){
+	unsigned char frame[SIM_FRAME_SIZE];
+	unsigned char reply[SIM_MAX_REPLY];
+	unsigned long frames = 0;
+	unsigned long corrupted = 0;
+
+	startSimDynamics(dynamics, getSimTime());
+	while(receiveFrame(client, frame) == 0){
+		// the axes are moved to the time of the frame, a written value takes effect immediately
+		advanceSimDynamics(dynamics, board, getSimTime());
+		observeSimFrame(dynamics, frame);
+		size_t size = handleSimFrame(board, frame, reply);
+		if(frame[1] == 3){
+			advanceSimDynamics(dynamics, board, getSimTime());
+		}
+		long delay = options->latency;
+		if(options->jitter > 0){
+			delay += rand() % (options->jitter + 1);
+		}
+		sleepMicroseconds(delay);
+		if(options->corruption > 0 && rand() < options->corruption * ((double)RAND_MAX + 1)){
+			reply[rand() % size] ^= 1 << (rand() % 8);
+			corrupted++;
+		}
+		size_t sent = 0;
+		while(sent < size){
+			int bytesSent = send(client, (char*) &reply[sent], size - sent, 0);
+			if(bytesSent <= 0){
+				return;
+			}
+			sent += bytesSent;
+		}
+		frames++;
+	}
+	printf("Connection closed after %lu frames, %lu replies corrupted\n",frames,corrupted);
+	printSimDynamics(dynamics, stdout);
+}
+
+
+int main(int argc, char *argv[]){
+	SimOptions options = { DEFAULT_PORT, DEFAULT_ITEM_TABLE, 0, 0, 0, (unsigned int)time(NULL) };
+	SimBoard board;
+	SimDynamics dynamics;
+
+	if(parseOptions(argc, argv, &options) == 1){
+		fprintf(stderr,"Usage: %s [-p port] [-c items.json] [-l latency_us] [-j jitter_us] "
+				"[-e corruption_rate] [-s seed]\n",argv[0]);
+		return EXIT_FAILURE;
+	}
+	srand(options.seed);
+	cJSON *table = readSimTable(options.itemTable);
+	if(table == NULL || initSimBoard(&board) == 1 || loadSimItems(&board, table) == 1
+			|| loadSimDynamics(&dynamics, &board, table) == 1){
+		cJSON_Delete(table);
+		return EXIT_FAILURE;
+	}
+	cJSON_Delete(table);
+
+#ifdef _WIN32
+	WSADATA wsaData;
+	if(WSAStartup(MAKEWORD(2, 2), &wsaData) != 0){
+		fprintf(stderr,"WSAStartup failed\n");
+		return EXIT_FAILURE;
+	}
+#endif
+	SOCKET server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if(server == INVALID_SOCKET){
+		fprintf(stderr,"Socket couldn't be created\n");
+		return EXIT_FAILURE;
+	}
+	int enable = 1;
+	setsockopt(server, SOL_SOCKET, SO_REUSEADDR, (char*) &enable, sizeof(enable));
+
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(options.port);
+	if(bind(server, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(server, 1) != 0){
+		fprintf(stderr,"Port %d couldn't be bound\n",options.port);
+		closesocket(server);
+		return EXIT_FAILURE;
+	}
+	printf("Simulating %d items and %d axes on port %d (latency %ld us, jitter %ld us, corruption %.4f, seed %u)\n",
+			board.itemCount, dynamics.axisCount, options.port, options.latency, options.jitter, options.corruption,
+			options.seed);
+	fflush(stdout);
+
+	while(1){
+		struct sockaddr_in clientAddress;
+		socklen_t addressLength = sizeof(clientAddress);
+		SOCKET client = accept(server, (struct sockaddr*) &clientAddress, &addressLength);
+		if(client == INVALID_SOCKET){
+			continue;
+		}
+		// replies are small, Nagle would delay them until the next frame arrives
+		setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (char*) &enable, sizeof(enable));
+		serveClient(&board, &dynamics, client, &options);
+		closesocket(client);
+	}
+
+	freeSimBoard(&board);
+	return EXIT_SUCCESS;
+}
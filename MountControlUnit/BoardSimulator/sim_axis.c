@@ -0,0 +1,382 @@
+/**
+ * @file sim_axis.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Simulated servo axes and system identification of the board simulator
+ *
+ * @details Every axis integrates its velocity towards vel_targ while the run bit is set, limited by vel_lim and
+ *	acc_lim, and exposes the position like the encoder: the fraction of a revolution in the lower 30 bits and the
+ *	parity of the revolution in bit 30, as decoded by readPosFromBoard. The model is advanced lazily to the time
+ *	of every frame, so it needs no thread of its own.
+ *	The sysid items run a sweep of sweepTime seconds after the start bit was set. Afterwards amplitude, phase and
+ *	frequency of the selected sysid_index are taken from a plant with two poles.
+ *	To measure the closed loop, the rate of the position reads and the overshoot after every reversal of the
+ *	target velocity are counted.
+ **/
+
+#include <math.h>
+#include <string.h>
+
+#include "sim_axis.h"
+
+#define SIM_PI 3.14159265358979323846
+
+
+/**
+ * @brief Looks up the item named by a key of the model description
+ * @param board Board holding the items
+ * @param object Model description
+ * @param key Key holding the item name
+ * @param item Destination of the item, NULL if the key is missing
+ * @param required 1 if the key has to be present
+ * @return 0 on success, 1 if a required key is missing or the item doesn't exist
+ */
+static int getSimItemRef(SimBoard *board, cJSON *object, const char *key, SimItem **item, int required){
+	cJSON *name = cJSON_GetObjectItem(object, key);
+	*item = NULL;
+	if(!cJSON_IsString(name)){
+		if(required){
+			fprintf(stderr,"Axis model needs the item \"%s\"\n",key);
+			return 1;
+		}
+		return 0;
+	}
+	*item = findSimItem(board, name->valuestring);
+	if(*item == NULL){
+		fprintf(stderr,"Item %s of the axis model is not in the item table\n",name->valuestring);
+		return 1;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Builds the mask of a bit field of the model description
+ * @param object Model description
+ * @param key Key holding the number of the first bit
+ * @param fallback Bit used if the key is missing
+ * @return Mask of the bit
+ */
+static uint32_t getSimBitMask(cJSON *object, const char *key, int fallback){
+	int bit = (int)getSimNumber(object, key, fallback);
+	return bit >= 0 && bit < 32 ? 1u << bit : 0;
+}
+
+
+/**
+ * @brief Writes the position of an axis in the encoding of the encoder
+ * @param board Board holding the position item
+ * @param axis Axis to write
+ */
+static void writeSimPosition(SimBoard *board, SimAxis *axis){
+	int64_t counts = (int64_t)floor(axis->pos * (double)(1 << SIM_POSITION_BITS));
+	uint32_t raw = (uint32_t)(counts & ((1 << SIM_POSITION_BITS) - 1))
+			| (uint32_t)((counts >> SIM_POSITION_BITS) & 1) << SIM_POSITION_BITS;
+	if(axis->position->lenTyp == 12){
+		setSimItemValue(board, axis->position, raw);
+	}else{
+		setSimItemBits(board, axis->position, raw);
+	}
+}
+
+
+/**
+ * @brief Loads the sysid part of the model description
+ * @param sysid Destination
+ * @param board Board holding the items
+ * @param object Description of the sysid items
+ * @return 0 on success, 1 otherwise
+ */
+static int loadSimSysid(SimSysid *sysid, SimBoard *board, cJSON *object){
+	if(getSimItemRef(board, object, "control", &sysid->control, 1) == 1
+			|| getSimItemRef(board, object, "status", &sysid->status, 1) == 1
+			|| getSimItemRef(board, object, "length", &sysid->length, 1) == 1
+			|| getSimItemRef(board, object, "index", &sysid->index, 1) == 1
+			|| getSimItemRef(board, object, "minFreq", &sysid->minFreq, 1) == 1
+			|| getSimItemRef(board, object, "maxFreq", &sysid->maxFreq, 1) == 1
+			|| getSimItemRef(board, object, "amplitude", &sysid->amplitude, 1) == 1
+			|| getSimItemRef(board, object, "phase", &sysid->phase, 1) == 1
+			|| getSimItemRef(board, object, "frequency", &sysid->frequency, 1) == 1){
+		return 1;
+	}
+	sysid->startMask = getSimBitMask(object, "startBit", 0);
+	sysid->resetMask = getSimBitMask(object, "resetBit", 4);
+	sysid->busyMask = getSimBitMask(object, "busyBit", 0);
+	sysid->doneMask = getSimBitMask(object, "doneBit", 1);
+	sysid->indexShift = (int)getSimNumber(object, "indexBit", 2);
+	int indexSize = (int)getSimNumber(object, "indexSize", 9);
+	sysid->indexMask = ((1u << indexSize) - 1) << sysid->indexShift;
+	sysid->sweepTime = getSimNumber(object, "sweepTime", 5);
+	sysid->gain = getSimNumber(object, "gain", 1);
+	sysid->pole1 = getSimNumber(object, "pole1", 20);
+	sysid->pole2 = getSimNumber(object, "pole2", 800);
+	return 0;
+}
+
+
+/**
+ * Loads the axis model. "axes" lists the items of every axis: run item and bit, vel_targ, vel_lim, acc_lim and
+ * position, plus the start angle in degrees. "sysid" names the items of the system identification and the
+ * position of its bits. Both parts are optional, a table without them simulates a board without dynamics.
+ *
+ * @param dynamics Model to load
+ * @param board Board holding the items
+ * @param root Parsed item table
+ * @return 0 on success, 1 otherwise
+ */
+int loadSimDynamics(SimDynamics *dynamics, SimBoard *board, cJSON *root){
+	memset(dynamics, 0, sizeof(SimDynamics));
+
+	cJSON *axes = cJSON_GetObjectItem(root, "axes");
+	cJSON *object;
+	cJSON_ArrayForEach(object, axes){
+		if(dynamics->axisCount == SIM_MAX_AXES){
+			fprintf(stderr,"Axis model holds more than %d axes\n",SIM_MAX_AXES);
+			return 1;
+		}
+		SimAxis *axis = &dynamics->axes[dynamics->axisCount];
+		if(getSimItemRef(board, object, "run", &axis->run, 1) == 1
+				|| getSimItemRef(board, object, "velTarg", &axis->velTarg, 1) == 1
+				|| getSimItemRef(board, object, "velLim", &axis->velLim, 0) == 1
+				|| getSimItemRef(board, object, "accLim", &axis->accLim, 0) == 1
+				|| getSimItemRef(board, object, "position", &axis->position, 1) == 1){
+			return 1;
+		}
+		axis->runMask = getSimBitMask(object, "runBit", 0);
+		axis->pos = getSimNumber(object, "start", 0) / 360.0;
+		writeSimPosition(board, axis);
+		dynamics->axisCount++;
+	}
+
+	cJSON *sysid = cJSON_GetObjectItem(root, "sysid");
+	if(cJSON_IsObject(sysid)){
+		if(loadSimSysid(&dynamics->sysid, board, sysid) == 1){
+			return 1;
+		}
+		dynamics->hasSysid = 1;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Starts a new measurement, called when a client connects
+ * @param dynamics Model
+ * @param now Current time in s
+ */
+void startSimDynamics(SimDynamics *dynamics, double now){
+	dynamics->time = now;
+	dynamics->startTime = now;
+	for(int i = 0; i < dynamics->axisCount; i++){
+		SimAxis *axis = &dynamics->axes[i];
+		axis->positionReads = 0;
+		axis->minPos = axis->pos;
+		axis->maxPos = axis->pos;
+		axis->reversing = 0;
+		axis->reversals = 0;
+		axis->overshootSum = 0;
+		axis->overshootMax = 0;
+	}
+}
+
+
+/**
+ * @brief Ends the overshoot measurement of a reversal once the axis turned
+ * @param axis Axis
+ */
+static void finishSimReversal(SimAxis *axis){
+	double overshoot = fabs(axis->peakPos - axis->reversalPos) * 360.0;
+	axis->overshootSum += overshoot;
+	if(overshoot > axis->overshootMax){
+		axis->overshootMax = overshoot;
+	}
+	axis->reversals++;
+	axis->reversing = 0;
+}
+
+
+/**
+ * Advances an axis. The inputs are taken from the RAM image once, they only change with the frames.
+ *
+ * @param axis Axis to advance
+ * @param board Board holding the items
+ * @param dt Time step in s
+ */
+static void advanceSimAxis(SimAxis *axis, SimBoard *board, double dt){
+	double target = 0;
+	if(getSimItemBits(board, axis->run) & axis->runMask){
+		target = getSimItemValue(board, axis->velTarg);
+	}
+	double velLim = axis->velLim != NULL ? fabs(getSimItemValue(board, axis->velLim)) : 0;
+	double accLim = axis->accLim != NULL ? fabs(getSimItemValue(board, axis->accLim)) : 0;
+	if(velLim > 0){
+		target = fmax(-velLim, fmin(velLim, target));
+	}
+
+	// a new target of the opposite sign starts the overshoot measurement
+	if(target * axis->target < 0 && axis->reversing == 0){
+		axis->reversing = axis->target > 0 ? 1 : -1;
+		axis->reversalPos = axis->pos;
+		axis->peakPos = axis->pos;
+	}
+	if(target != 0){
+		axis->target = target;
+	}
+
+	int steps = (int)ceil(dt / SIM_AXIS_STEP);
+	double h = steps > 0 ? dt / steps : 0;
+	for(int i = 0; i < steps; i++){
+		double change = target - axis->vel;
+		if(accLim > 0){
+			change = fmax(-accLim * h, fmin(accLim * h, change));
+		}
+		axis->vel += change;
+		axis->pos += axis->vel * h;
+
+		axis->minPos = fmin(axis->minPos, axis->pos);
+		axis->maxPos = fmax(axis->maxPos, axis->pos);
+		if(axis->reversing != 0){
+			if(axis->vel * axis->reversing > 0){
+				axis->peakPos = axis->pos;
+			}else{
+				finishSimReversal(axis);
+			}
+		}
+	}
+	writeSimPosition(board, axis);
+}
+
+
+/**
+ * @brief Writes amplitude, phase and frequency of a point of the sweep
+ * @param sysid Sysid model
+ * @param board Board holding the items
+ * @param index Index of the point, starting with 1
+ */
+static void writeSimSysidResult(SimSysid *sysid, SimBoard *board, uint32_t index){
+	double length = getSimItemValue(board, sysid->length);
+	double minFreq = getSimItemValue(board, sysid->minFreq);
+	double maxFreq = getSimItemValue(board, sysid->maxFreq);
+	double frequency = minFreq;
+	if(length > 1 && minFreq > 0 && maxFreq > minFreq){
+		frequency = minFreq * pow(maxFreq / minFreq, (index - 1) / (length - 1));
+	}
+	double ratio1 = frequency / sysid->pole1;
+	double ratio2 = frequency / sysid->pole2;
+	double amplitude = sysid->gain / sqrt((1 + ratio1 * ratio1) * (1 + ratio2 * ratio2));
+	double phase = -(atan(ratio1) + atan(ratio2));
+
+	setSimItemValue(board, sysid->amplitude, amplitude);
+	setSimItemValue(board, sysid->phase, phase);
+	setSimItemValue(board, sysid->frequency, frequency);
+	uint32_t status = getSimItemBits(board, sysid->status) & ~sysid->indexMask;
+	setSimItemBits(board, sysid->status, status | ((index << sysid->indexShift) & sysid->indexMask));
+	sysid->readIndex = index;
+}
+
+
+/**
+ * Advances the sweep. The reset bit clears the sysid state and is cleared itself, the start bit starts a sweep
+ * unless the last one is done and not reset yet. After the sweep every new sysid_index selects a result.
+ *
+ * @param sysid Sysid model
+ * @param board Board holding the items
+ * @param dt Time step in s
+ */
+static void advanceSimSysid(SimSysid *sysid, SimBoard *board, double dt){
+	uint32_t control = getSimItemBits(board, sysid->control);
+	uint32_t status = getSimItemBits(board, sysid->status);
+
+	if(control & sysid->resetMask){
+		setSimItemBits(board, sysid->control, control & ~(sysid->resetMask | sysid->startMask));
+		setSimItemBits(board, sysid->status, 0);
+		sysid->running = 0;
+		sysid->readIndex = 0;
+		return;
+	}
+	if((control & sysid->startMask) && !sysid->running && !(status & sysid->doneMask)){
+		sysid->running = 1;
+		sysid->elapsed = 0;
+		status = (status | sysid->busyMask) & ~sysid->doneMask;
+	}
+	if(sysid->running){
+		sysid->elapsed += dt;
+		if(sysid->elapsed >= sysid->sweepTime){
+			sysid->running = 0;
+			status = (status | sysid->doneMask) & ~sysid->busyMask;
+		}
+	}
+	setSimItemBits(board, sysid->status, status);
+
+	uint32_t index = (uint32_t)getSimItemValue(board, sysid->index);
+	if((status & sysid->doneMask) && index != sysid->readIndex && index >= 1
+			&& index <= (uint32_t)getSimItemValue(board, sysid->length)){
+		writeSimSysidResult(sysid, board, index);
+	}
+}
+
+
+/**
+ * @brief Advances all axes and the sweep to the given time
+ * @param dynamics Model
+ * @param board Board holding the items
+ * @param now Current time in s
+ */
+void advanceSimDynamics(SimDynamics *dynamics, SimBoard *board, double now){
+	double dt = now - dynamics->time;
+	if(dt < 0){
+		dt = 0;
+	}
+	dynamics->time = now;
+	for(int i = 0; i < dynamics->axisCount; i++){
+		advanceSimAxis(&dynamics->axes[i], board, dt);
+	}
+	if(dynamics->hasSysid){
+		advanceSimSysid(&dynamics->sysid, board, dt);
+	}
+}
+
+
+/**
+ * @brief Counts the position reads of the client
+ * @param dynamics Model
+ * @param frame Frame received from the client
+ */
+void observeSimFrame(SimDynamics *dynamics, const unsigned char *frame){
+	if(frame[1] != 4){
+		return;
+	}
+	uint32_t address = frame[2] | frame[3] << 8 | frame[4] << 16;
+	for(int i = 0; i < dynamics->axisCount; i++){
+		if(dynamics->axes[i].position->address == address){
+			dynamics->axes[i].positionReads++;
+		}
+	}
+}
+
+
+/**
+ * @brief Prints the loop rate and the overshoot measured since the client connected
+ * @param dynamics Model
+ * @param stream Stream to print to
+ */
+void printSimDynamics(SimDynamics *dynamics, FILE *stream){
+	double duration = dynamics->time - dynamics->startTime;
+	for(int i = 0; i < dynamics->axisCount; i++){
+		SimAxis *axis = &dynamics->axes[i];
+		fprintf(stream, "%s: %llu reads in %.1f s (%.1f Hz), travel %.2f .. %.2f deg, %u reversals",
+				axis->position->name, (unsigned long long)axis->positionReads, duration,
+				duration > 0 ? axis->positionReads / duration : 0, axis->minPos * 360.0, axis->maxPos * 360.0,
+				axis->reversals);
+		if(axis->reversals > 0){
+			fprintf(stream, ", overshoot mean %.3f deg max %.3f deg",
+					axis->overshootSum / axis->reversals, axis->overshootMax);
+		}
+		fprintf(stream, "\n");
+	}
+	if(dynamics->hasSysid){
+		fprintf(stream, "sysid: %s\n", dynamics->sysid.running ? "sweep running" : "idle");
+	}
+	fflush(stream);
+}
@@ -0,0 +1,84 @@
+/*
+ * sim_axis.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef SIM_AXIS_H_
+#define SIM_AXIS_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "sim_board.h"
+
+#define SIM_MAX_AXES 2
+#define SIM_AXIS_STEP 0.001			// longest integration step in s
+#define SIM_POSITION_BITS 30		// resolution of one revolution in the position items
+
+typedef struct
+{
+	SimItem *run;				// item holding the run bit
+	uint32_t runMask;
+	SimItem *velTarg;			// target velocity in rev/s
+	SimItem *velLim;			// velocity limit in rev/s, 0 disables the limit
+	SimItem *accLim;			// acceleration limit in rev/s^2, 0 disables the limit
+	SimItem *position;
+	double pos;					// position in revolutions
+	double vel;					// velocity in rev/s
+	double target;				// velocity the axis accelerates to
+	// measurement of the closed loop
+	uint64_t positionReads;
+	double minPos;
+	double maxPos;
+	double reversalPos;			// position at which the last reversal of the target velocity was commanded
+	double peakPos;				// farthest position reached in the old direction since the reversal
+	int reversing;				// direction before the reversal until the axis turned, 0 otherwise
+	uint32_t reversals;
+	double overshootSum;		// distance travelled after the reversals in degrees
+	double overshootMax;
+} SimAxis;
+
+typedef struct
+{
+	SimItem *control;			// start and reset bits
+	uint32_t startMask;
+	uint32_t resetMask;
+	SimItem *status;			// busy and done flags, index of the result ready to read
+	uint32_t busyMask;
+	uint32_t doneMask;
+	int indexShift;
+	uint32_t indexMask;
+	SimItem *length;
+	SimItem *index;
+	SimItem *minFreq;
+	SimItem *maxFreq;
+	SimItem *amplitude;
+	SimItem *phase;
+	SimItem *frequency;
+	double sweepTime;			// duration of a sweep in s
+	double gain;				// measured plant: gain / ((1 + j f/pole1) (1 + j f/pole2))
+	double pole1;				// in Hz
+	double pole2;
+	int running;
+	double elapsed;
+	uint32_t readIndex;			// index of the result currently held by amplitude, phase and frequency
+} SimSysid;
+
+typedef struct
+{
+	SimAxis axes[SIM_MAX_AXES];
+	int axisCount;
+	SimSysid sysid;
+	int hasSysid;
+	double time;				// time the model was advanced to in s
+	double startTime;
+} SimDynamics;
+
+int loadSimDynamics(SimDynamics *dynamics, SimBoard *board, cJSON *root);
+void startSimDynamics(SimDynamics *dynamics, double now);
+void advanceSimDynamics(SimDynamics *dynamics, SimBoard *board, double now);
+void observeSimFrame(SimDynamics *dynamics, const unsigned char *frame);
+void printSimDynamics(SimDynamics *dynamics, FILE *stream);
+
+#endif /* SIM_AXIS_H_ */
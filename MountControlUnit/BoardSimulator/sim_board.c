@@ -0,0 +1,419 @@
+/**
+ * @file sim_board.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Simulated ASA Board answering the 16 byte frames of the AxisController
+ *
+ * @details The board holds an item table and a RAM image. Every frame built by encode() is checked for its
+ *	checksum and answered like the real board: status (function 0), item count (1), item description (2),
+ *	write RAM (3) and read RAM (4). Replies are split into packages of up to 14 payload bytes, every package
+ *	starts with the function code and ends with a checksum, so the bytes of each package sum up to zero.
+ *	Rejected frames are answered with SIM_INVALID_FUNCTION instead of the function code, which makes the client
+ *	retry the frame.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "sim_board.h"
+
+#define SIM_PACKAGE_PAYLOAD 14
+#define SIM_MAX_PAYLOAD 112			// largest payload fitting into SIM_MAX_REPLY
+#define SIM_DESCRIBE_DATA 13		// item data per package of a description, the first byte is skipped
+
+
+/**
+ * @brief Initialises an empty board with a cleared RAM image
+ * @param board Board to initialise
+ * @return 0 on success, 1 if the RAM image couldn't be allocated
+ */
+int initSimBoard(SimBoard *board){
+	memset(board, 0, sizeof(SimBoard));
+	board->ram = calloc(SIM_RAM_SIZE, 1);
+	if(board->ram == NULL){
+		fprintf(stderr,"Memory allocation for the RAM image failed\n");
+		return 1;
+	}
+	return 0;
+}
+
+
+void freeSimBoard(SimBoard *board){
+	free(board->ram);
+	board->ram = NULL;
+	board->itemCount = 0;
+}
+
+
+/**
+ * @brief Maps the type name of the item table to the length type of the board
+ * @param type Type name (int16, uint16, int32, uint32, float)
+ * @return Length type, 0 if the type is unknown
+ */
+static uint8_t getSimLenTyp(const char *type){
+	static const char *types[] = { "int16", "uint16", "int32", "uint32", "float" };
+	for(int i = 0; i < 5; i++){
+		if(strcmp(type, types[i]) == 0){
+			return 8 + i;
+		}
+	}
+	return 0;
+}
+
+
+size_t getSimItemSize(SimItem *item){
+	return item->lenTyp > 9 ? 4 : 2;
+}
+
+
+/**
+ * @brief Converts a number of the item table into the raw little endian representation of the item type
+ * @param lenTyp Length type of the item
+ * @param value Value to convert
+ * @param raw Destination of 4 bytes
+ */
+static void encodeSimValue(uint8_t lenTyp, double value, uint8_t *raw){
+	uint32_t bits;
+	float f;
+	switch(lenTyp){
+	case 8:
+		bits = (uint16_t)(int16_t)value;
+		break;
+	case 9:
+		bits = (uint16_t)value;
+		break;
+	case 10:
+		bits = (uint32_t)(int32_t)value;
+		break;
+	case 11:
+		bits = (uint32_t)value;
+		break;
+	default:
+		f = (float)value;
+		memcpy(&bits, &f, sizeof(bits));
+		break;
+	}
+	for(int i = 0; i < 4; i++){
+		raw[i] = (bits >> (i * 8)) & 0xFF;
+	}
+}
+
+
+/**
+ * @brief Reads a number of an item of the table
+ * @param object Item of the table
+ * @param key Name of the number
+ * @param fallback Value used if the item has no such number
+ * @return Value of the number
+ */
+double getSimNumber(cJSON *object, const char *key, double fallback){
+	cJSON *number = cJSON_GetObjectItem(object, key);
+	if(cJSON_IsNumber(number)){
+		return number->valuedouble;
+	}
+	return fallback;
+}
+
+
+/**
+ * @brief Copies a string of an item of the table into a fixed size field
+ * @param object Item of the table
+ * @param key Name of the string
+ * @param field Destination, filled up with zeros
+ * @param size Size of the destination
+ */
+static void getSimString(cJSON *object, const char *key, char *field, size_t size){
+	cJSON *string = cJSON_GetObjectItem(object, key);
+	memset(field, 0, size);
+	if(cJSON_IsString(string)){
+		strncpy(field, string->valuestring, size);
+	}
+}
+
+
+/**
+ * @brief Reads and parses the JSON file holding the item table and the axis model
+ * @param fileName Name of the file
+ * @return Parsed file, NULL on failure. Has to be freed with cJSON_Delete.
+ */
+cJSON* readSimTable(char *fileName){
+	FILE *file = fopen(fileName, "rb");
+	if(file == NULL){
+		fprintf(stderr,"Item table %s couldn't be opened\n",fileName);
+		return NULL;
+	}
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	char *content = malloc(length + 1);
+	if(content == NULL || fread(content, 1, length, file) != (size_t)length){
+		fprintf(stderr,"Item table %s couldn't be read\n",fileName);
+		free(content);
+		fclose(file);
+		return NULL;
+	}
+	content[length] = '\0';
+	fclose(file);
+
+	cJSON *root = cJSON_Parse(content);
+	free(content);
+	if(root == NULL){
+		fprintf(stderr,"Item table %s is no valid JSON\n",fileName);
+	}
+	return root;
+}
+
+
+/**
+ * Loads the item table of the board. The table holds the board status and an array of items, every item has
+ * a name, a RAM address and a type (int16, uint16, int32, uint32, float). Flags, symbol, scale, unit, min, max
+ * and the default value are optional. The default values are written to the RAM image.
+ *
+ * @param board Initialised board
+ * @param root Parsed item table
+ * @return 0 on success, 1 otherwise
+ */
+int loadSimItems(SimBoard *board, cJSON *root){
+	cJSON *items = cJSON_GetObjectItem(root, "items");
+	if(!cJSON_IsArray(items)){
+		fprintf(stderr,"Item table holds no items array\n");
+		return 1;
+	}
+	board->status = (uint8_t)getSimNumber(root, "status", 0);
+
+	cJSON *object;
+	cJSON_ArrayForEach(object, items){
+		if(board->itemCount == SIM_MAX_ITEMS){
+			fprintf(stderr,"Item table holds more than %d items\n",SIM_MAX_ITEMS);
+			return 1;
+		}
+		SimItem *item = &board->items[board->itemCount];
+		cJSON *name = cJSON_GetObjectItem(object, "name");
+		cJSON *type = cJSON_GetObjectItem(object, "type");
+		cJSON *address = cJSON_GetObjectItem(object, "address");
+		if(!cJSON_IsString(name) || !cJSON_IsString(type) || !cJSON_IsNumber(address)){
+			fprintf(stderr,"Item %d needs a name, a type and an address\n",board->itemCount);
+			return 1;
+		}
+		memset(item, 0, sizeof(SimItem));
+		strncpy(item->name, name->valuestring, sizeof(item->name) - 1);
+		item->address = (uint32_t)address->valuedouble;
+		item->lenTyp = getSimLenTyp(type->valuestring);
+		if(item->lenTyp == 0 || item->address + getSimItemSize(item) > SIM_RAM_SIZE){
+			fprintf(stderr,"Item %s has an unknown type or an invalid address\n",item->name);
+			return 1;
+		}
+		item->flags = (uint16_t)getSimNumber(object, "flags", 0);
+		getSimString(object, "symbol", item->symbol, sizeof(item->symbol));
+		getSimString(object, "unit", item->unit, sizeof(item->unit));
+		item->scaleFactor = (float)getSimNumber(object, "scale", 1);
+		encodeSimValue(item->lenTyp, getSimNumber(object, "min", 0), item->minVal);
+		encodeSimValue(item->lenTyp, getSimNumber(object, "max", 0), item->maxVal);
+		encodeSimValue(item->lenTyp, getSimNumber(object, "default", 0), item->defaultValue);
+		memcpy(&board->ram[item->address], item->defaultValue, getSimItemSize(item));
+		board->itemCount++;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Searches an item of the table by its name
+ * @param board Board holding the items
+ * @param name Name of the item
+ * @return The item, NULL if the board has no such item
+ */
+SimItem* findSimItem(SimBoard *board, const char *name){
+	for(int i = 0; i < board->itemCount; i++){
+		if(strcmp(board->items[i].name, name) == 0){
+			return &board->items[i];
+		}
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief Reads the raw bits of an item from the RAM image
+ * @param board Board holding the item
+ * @param item Item to read
+ * @return Raw little endian value, 2 byte items are zero extended
+ */
+uint32_t getSimItemBits(SimBoard *board, SimItem *item){
+	uint32_t bits = 0;
+	for(size_t i = 0; i < getSimItemSize(item); i++){
+		bits |= (uint32_t)board->ram[item->address + i] << (i * 8);
+	}
+	return bits;
+}
+
+
+void setSimItemBits(SimBoard *board, SimItem *item, uint32_t bits){
+	for(size_t i = 0; i < getSimItemSize(item); i++){
+		board->ram[item->address + i] = (bits >> (i * 8)) & 0xFF;
+	}
+}
+
+
+/**
+ * @brief Reads an item from the RAM image and converts it according to its type
+ * @param board Board holding the item
+ * @param item Item to read
+ * @return Value of the item
+ */
+double getSimItemValue(SimBoard *board, SimItem *item){
+	uint32_t bits = getSimItemBits(board, item);
+	float f;
+	switch(item->lenTyp){
+	case 8:
+		return (int16_t)bits;
+	case 10:
+		return (int32_t)bits;
+	case 12:
+		memcpy(&f, &bits, sizeof(f));
+		return f;
+	default:
+		return bits;
+	}
+}
+
+
+void setSimItemValue(SimBoard *board, SimItem *item, double value){
+	uint8_t raw[4];
+	encodeSimValue(item->lenTyp, value, raw);
+	memcpy(&board->ram[item->address], raw, getSimItemSize(item));
+}
+
+
+/**
+ * Writes the description of an item in the layout decoded by extractInformationFromData: name (32 bytes),
+ * address (3), length type (2), flags (2), symbol (10), scale factor (4), unit (6), min (4) and max (4).
+ * Every package carries 13 bytes of the description after a skipped first payload byte, so only the first
+ * 65 bytes of the description fit into the 70 payload bytes.
+ *
+ * @param item Item to describe
+ * @param payload Destination of SIM_DESCRIBE_SIZE bytes
+ */
+static void describeSimItem(SimItem *item, unsigned char *payload){
+	unsigned char data[72] = { 0 };
+	memcpy(&data[0], item->name, sizeof(item->name));
+	for(int i = 0; i < 3; i++){
+		data[32 + i] = (item->address >> (i * 8)) & 0xFF;
+	}
+	data[35] = item->lenTyp;
+	data[37] = item->flags & 0xFF;
+	data[38] = item->flags >> 8;
+	memcpy(&data[39], item->symbol, sizeof(item->symbol));
+	memcpy(&data[49], &item->scaleFactor, sizeof(item->scaleFactor));
+	memcpy(&data[53], item->unit, sizeof(item->unit));
+	memcpy(&data[59], item->minVal, sizeof(item->minVal));
+	memcpy(&data[63], item->maxVal, sizeof(item->maxVal));
+
+	for(int package = 0; package * SIM_PACKAGE_PAYLOAD < SIM_DESCRIBE_SIZE; package++){
+		payload[package * SIM_PACKAGE_PAYLOAD] = package;
+		memcpy(&payload[package * SIM_PACKAGE_PAYLOAD + 1], &data[package * SIM_DESCRIBE_DATA], SIM_DESCRIBE_DATA);
+	}
+}
+
+
+/**
+ * @brief Splits a payload into packages and adds function code and checksum to every package
+ * @param function Function code echoed at the start of every package
+ * @param payload Payload of the reply
+ * @param length Number of payload bytes
+ * @param reply Destination of the reply
+ * @return Size of the reply in bytes
+ */
+static size_t buildSimReply(unsigned char function, const unsigned char *payload, size_t length,
+		unsigned char *reply){
+	size_t size = 0;
+	size_t offset = 0;
+	do{
+		size_t package = length - offset;
+		if(package > SIM_PACKAGE_PAYLOAD){
+			package = SIM_PACKAGE_PAYLOAD;
+		}
+		unsigned int sum = function;
+		reply[size++] = function;
+		for(size_t i = 0; i < package; i++){
+			reply[size++] = payload[offset + i];
+			sum += payload[offset + i];
+		}
+		reply[size++] = (256 - (sum & 0xFF)) & 0xFF;
+		offset += package;
+	}while(offset < length);
+	return size;
+}
+
+
+/**
+ * Answers a single frame. The frame is executed only if its checksum is valid and its parameters fit the
+ * board, otherwise the reply has the expected size but carries SIM_INVALID_FUNCTION.
+ *
+ * @param board Board executing the frame
+ * @param frame Frame of SIM_FRAME_SIZE bytes
+ * @param reply Destination of the reply, has to hold SIM_MAX_REPLY bytes
+ * @return Size of the reply in bytes
+ */
+size_t handleSimFrame(SimBoard *board, const unsigned char *frame, unsigned char *reply){
+	unsigned char payload[SIM_MAX_REPLY] = { 0 };
+	unsigned char function = frame[1];
+	uint32_t address = frame[2] | frame[3] << 8 | frame[4] << 16;
+	size_t length = 0;
+	int valid = 1;
+
+	unsigned int sum = 0;
+	for(int i = 1; i < SIM_FRAME_SIZE; i++){
+		sum += frame[i];
+	}
+	if((sum & 0xFF) != 0){
+		valid = 0;
+	}
+
+	switch(function){
+	case 0:
+		length = 2;
+		payload[0] = board->status;
+		break;
+	case 1:
+		length = 2;
+		payload[0] = board->itemCount & 0xFF;
+		payload[1] = board->itemCount >> 8;
+		break;
+	case 2:
+		length = SIM_DESCRIBE_SIZE;
+		if(valid && frame[4] < board->itemCount){
+			describeSimItem(&board->items[frame[4]], payload);
+		}
+		break;
+	case 3:
+		// frame[0] counts function code, address and data, the checksum has to fit into the frame
+		if(frame[0] < 5 || frame[0] > SIM_FRAME_SIZE - 2 || address + frame[0] - 4 > SIM_RAM_SIZE){
+			valid = 0;
+		}else if(valid){
+			memcpy(&board->ram[address], &frame[5], frame[0] - 4);
+		}
+		break;
+	case 4:
+		length = frame[5];
+		if(length == 0 || length > SIM_MAX_PAYLOAD || address + length > SIM_RAM_SIZE){
+			length = length > SIM_MAX_PAYLOAD ? SIM_MAX_PAYLOAD : length;
+			valid = 0;
+		}else if(valid){
+			memcpy(payload, &board->ram[address], length);
+		}
+		break;
+	default:
+		valid = 0;
+		break;
+	}
+
+	if(!valid){
+		memset(payload, 0, sizeof(payload));
+		function = SIM_INVALID_FUNCTION;
+	}
+	return buildSimReply(function, payload, length, reply);
+}
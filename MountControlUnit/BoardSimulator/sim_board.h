@@ -0,0 +1,57 @@
+/*
+ * sim_board.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef SIM_BOARD_H_
+#define SIM_BOARD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cJSON.h"
+
+#define SIM_FRAME_SIZE 16
+#define SIM_MAX_REPLY 128
+#define SIM_MAX_ITEMS 255			// the item count is replied in a single byte
+#define SIM_RAM_SIZE (1 << 24)		// addresses are 3 bytes wide
+#define SIM_DESCRIBE_SIZE 70		// payload bytes of an item description
+#define SIM_INVALID_FUNCTION 0xFF	// echoed instead of the function code if a frame is rejected
+
+typedef struct
+{
+	char name[32];
+	uint32_t address;
+	uint8_t lenTyp;				// 8: int16, 9: uint16, 10: int32, 11: uint32, 12: float
+	uint16_t flags;
+	char symbol[10];
+	float scaleFactor;
+	char unit[6];
+	uint8_t minVal[4];			// raw little endian values of the item type
+	uint8_t maxVal[4];
+	uint8_t defaultValue[4];
+} SimItem;
+
+typedef struct
+{
+	SimItem items[SIM_MAX_ITEMS];
+	int itemCount;
+	uint8_t status;				// replied to status requests, 0 if the board is ready
+	uint8_t *ram;
+} SimBoard;
+
+int initSimBoard(SimBoard *board);
+void freeSimBoard(SimBoard *board);
+cJSON* readSimTable(char *fileName);
+double getSimNumber(cJSON *object, const char *key, double fallback);
+int loadSimItems(SimBoard *board, cJSON *root);
+SimItem* findSimItem(SimBoard *board, const char *name);
+size_t getSimItemSize(SimItem *item);
+uint32_t getSimItemBits(SimBoard *board, SimItem *item);
+void setSimItemBits(SimBoard *board, SimItem *item, uint32_t bits);
+double getSimItemValue(SimBoard *board, SimItem *item);
+void setSimItemValue(SimBoard *board, SimItem *item, double value);
+size_t handleSimFrame(SimBoard *board, const unsigned char *frame, unsigned char *reply);
+
+#endif /* SIM_BOARD_H_ */
@@ -1,57 +1,178 @@
-#include <string>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
-#include <thread>
+
+#include "AxisHandler.h"
 
 extern "C"
 {
-  #include "axis_controller.h"
-  #include "thread_utils.h"	
+  #include "comm_stats.h"
+  #include "logz.h"
 }
 
-class AxisHandler {
+using namespace std;
 
-private:
-    // Member variables
-    string axisName;
-    string ipAddress;
-    int port;
-    SOCKET socket;
+AxisHandler::AxisHandler(int axleNum, string ipAddress, int port)
+    : connection(make_unique<BoardConnection>()), motion(Motion::Stopped), targetPosition(0), position(0), speed(DEFAULT_SPEED),
+      positionIndex(0), velocityItem(nullptr), runItem(nullptr), sentVelocity(0)
+{
+    initAxleArguments(&arguments, axleNum, ipAddress.c_str(), port);
+    initBoardConnection(connection.get());
+    initProcessImage(&processImage, connection.get(), PROCESS_IMAGE_PERIOD_NS);
+}
 
+AxisHandler::~AxisHandler()
+{
+    shutdown();
+}
 
-public:
-    // Constructor
-    AxisHandler(int axisName, string ipAddress, int port){
-        this->axisName = axisName;
-        this->ipAddress = ipAddress;
-        this->port = port;
-    }
+future<bool> AxisHandler::start(barrier<>& startBarrier, atomic<int>& failedAxes)
+{
+    initialised = promise<bool>();
+    future<bool> result = initialised.get_future();
+    thread = jthread([this, &startBarrier, &failedAxes](stop_token stopToken) {
+        run(stopToken, startBarrier, failedAxes);
+    });
+    return result;
+}
 
-    // Destructor
-    ~AxisHandler(){
-        cout << "AxisHandler object destroyed" << endl;
+void AxisHandler::shutdown()
+{
+    if (thread.joinable()) {
+        thread.request_stop();
+        thread.join();
     }
+}
 
-   //Member functions
+void AxisHandler::moveForward()
+{
+    motion = Motion::Forward;
+}
 
-    bool initialise(){
-        std::jthread t1(initialise, &socket);
+void AxisHandler::moveBackward()
+{
+    motion = Motion::Backward;
+}
 
-        int status = initialise(socket);
-        if (status == 0) {
-            return true;
-        } else {
-            return false;
-        }
+void AxisHandler::stop()
+{
+    motion = Motion::Stopped;
+}
+
+void AxisHandler::setPosition(double position)
+{
+    targetPosition = position;
+    motion = Motion::Position;
+}
+
+double AxisHandler::getPosition() const
+{
+    return position;
+}
+
+int AxisHandler::getAxleNum() const
+{
+    return arguments.axleNum;
+}
+
+// Body of the axle thread: initialise, wait for all axles at the barrier, run the cycles until stopped
+void AxisHandler::run(stop_token stopToken, barrier<>& startBarrier, atomic<int>& failedAxes)
+{
+    configureAxleThread(&arguments);
+    bool ready = initialise(connection.get()) == 0;
+    if (ready && !resolveItems()) {
+        fprintf(stderr, "ERROR: Resolving the motion items of axle %d failed\n", axleNum);
+        closeBoardConnection(connection.get());
+        ready = false;
+    }
+    if (!ready) {
+        failedAxes++;
     }
+    initialised.set_value(ready);
 
+    // no axle starts moving before every axle is initialised, a failed axle stops all of them
+    startBarrier.arrive_and_wait();
+    if (ready && failedAxes == 0 && !stopToken.stop_requested()) {
+        PeriodicExecutor executor;
+        initPeriodicExecutor(&executor, "axis cycle", MOTION_LOOP_PERIOD_NS, cycleCallback, this);
+        startMotor(connection.get());
+        if (startProcessImage(&processImage) == 0) {
+            stop_callback stopCycles(stopToken, [&executor]() { stopPeriodicExecutor(&executor); });
+            runPeriodicExecutor(&executor);
+        }
+        stopProcessImage(&processImage);
+        writeItemFloat(connection.get(), velocityItem, 0);
+        writeItem(connection.get(), runItem, 0);
+        dumpPeriodicStats(&executor, stdout);
+        dumpPeriodicStats(&processImage.executor, stdout);
+    }
+    if (ready) {
+        releaseItems();
+        dumpCommStats(&connection->stats, stdout);
+        closeBoardConnection(connection.get());
+    }
+    closeLogger();
+}
 
+bool AxisHandler::resolveItems()
+{
+    if (subscribeItem(&processImage, "pos_2", &positionIndex) == 1
+            || resolveItem(connection.get(), "vel_targ_2", &velocityItem) == 1
+            || resolveItem(connection.get(), "state_2.run", &runItem) == 1) {
+        releaseItems();
+        return false;
+    }
+    return true;
+}
 
+void AxisHandler::releaseItems()
+{
+    releaseProcessImage(&processImage);
+    releaseItem(velocityItem);
+    releaseItem(runItem);
+    velocityItem = nullptr;
+    runItem = nullptr;
+}
 
-    void moveForward();
-    void moveBackward();
-    void stop();
-    void setPosition(int position);
-    int getPosition();
+// One control cycle: take the position from the process image, send a new velocity target only if it changed
+int AxisHandler::cycle()
+{
+    ProcessImageSnapshot snapshot;
+    if (readProcessImage(&processImage, &snapshot) == 0 && snapshot.status[positionIndex] == 0) {
+        int32_t calcValue = (int32_t) snapshot.values[positionIndex] & 0x3FFFFFFF;
+        position = (double) calcValue * (360.0 / pow(2, 30));
+    }
+    float velocity = (float) (nextVelocity(position) * VEL_FACTOR);
+    if (velocity != sentVelocity) {
+        lockBoardConnection(connection.get());
+        if (writeItemFloat(connection.get(), velocityItem, velocity) == 0) {
+            sentVelocity = velocity;
+        }
+        unlockBoardConnection(connection.get());
+    }
+    return 0;
+}
 
+double AxisHandler::nextVelocity(double angle) const
+{
+    switch (motion.load()) {
+    case Motion::Forward:
+        return speed;
+    case Motion::Backward:
+        return -speed;
+    case Motion::Position: {
+        double error = targetPosition - angle;
+        if (fabs(error) < POSITION_TOLERANCE) {
+            return 0;
+        }
+        return error > 0 ? speed : -speed;
+    }
+    default:
+        return 0;
+    }
+}
 
-};
\ No newline at end of file
+int AxisHandler::cycleCallback(void *userData)
+{
+    return static_cast<AxisHandler*>(userData)->cycle();
+}
@@ -0,0 +1,84 @@
+/*
+ * AxisHandler.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef AXIS_HANDLER_H_
+#define AXIS_HANDLER_H_
+
+#include <atomic>
+#include <barrier>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "periodic_executor.h"
+#include "process_image.h"
+
+extern "C"
+{
+  #include "axis_controller.h"
+  #include "item_handle.h"
+  #include "thread_utils.h"
+}
+
+// Drives one axle. The axis owns the connection to its board, which is shared by the thread of the axle and the
+// poller of its process image. The motion commands only set the target of the next cycle and can be called from
+// any thread.
+class AxisHandler {
+
+public:
+    static constexpr double VEL_FACTOR = 0.002777;         // vel_targ per degree per second
+    static constexpr double DEFAULT_SPEED = 2;             // degrees per second
+    static constexpr double POSITION_TOLERANCE = 0.2;      // degrees
+
+    AxisHandler(int axleNum, std::string ipAddress, int port);
+    ~AxisHandler();
+
+    AxisHandler(const AxisHandler&) = delete;
+    AxisHandler& operator=(const AxisHandler&) = delete;
+
+    // Starts the thread of the axle, the result of its initialisation is delivered through the returned future
+    std::future<bool> start(std::barrier<>& startBarrier, std::atomic<int>& failedAxes);
+    // Stops the control cycle and waits for the thread of the axle
+    void shutdown();
+
+    void moveForward();
+    void moveBackward();
+    void stop();
+    void setPosition(double position);
+    double getPosition() const;
+    int getAxleNum() const;
+
+private:
+    enum class Motion { Stopped, Forward, Backward, Position };
+
+    AxleArguments arguments;
+    std::unique_ptr<BoardConnection> connection;
+    std::jthread thread;
+    std::promise<bool> initialised;
+
+    std::atomic<Motion> motion;
+    std::atomic<double> targetPosition;
+    std::atomic<double> position;
+    double speed;
+
+    // owned by the thread of the axle
+    ProcessImage processImage;     // position of the axle, read by the cycles without waiting for the board
+    int positionIndex;
+    ItemHandle *velocityItem;
+    ItemHandle *runItem;
+    float sentVelocity;
+
+    void run(std::stop_token stopToken, std::barrier<>& startBarrier, std::atomic<int>& failedAxes);
+    bool resolveItems();
+    void releaseItems();
+    int cycle();
+    double nextVelocity(double angle) const;
+    static int cycleCallback(void *userData);
+};
+
+#endif /* AXIS_HANDLER_H_ */
@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cstdio>
+#include <future>
+
+#include "MountController.h"
+
+using namespace std;
+
+MountController::MountController() : failedAxes(0), shutDown(true)
+{
+    // the shared directory holds Cl-Servos.ini, which is read by every axle during its initialisation
+    sem_init(&sharedDir, 0, 1);
+}
+
+MountController::~MountController()
+{
+    shutdown();
+    sem_destroy(&sharedDir);
+}
+
+AxisHandler& MountController::addAxis(string ipAddress, int port)
+{
+    axes.push_back(make_unique<AxisHandler>((int) axes.size() + 1, ipAddress, port));
+    return *axes.back();
+}
+
+bool MountController::start()
+{
+    vector<future<bool>> initialised;
+    auto begin = chrono::steady_clock::now();
+
+    if (axes.empty()) {
+        return false;
+    }
+    failedAxes = 0;
+    shutDown = false;
+    // the axes run in std::jthreads, the memory is locked here before any of them starts, not by startAxleThread
+    lockProcessMemory();
+    startBarrier = make_unique<barrier<>>((ptrdiff_t) axes.size());
+    for (auto& axis : axes) {
+        initialised.push_back(axis->start(*startBarrier, failedAxes));
+    }
+    for (size_t i = 0; i < initialised.size(); i++) {
+        if (!initialised[i].get()) {
+            fprintf(stderr, "ERROR: Axis %d couldn't be initialised\n", axes[i]->getAxleNum());
+        }
+    }
+    auto bringUp = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - begin);
+    printf("Bring-up of %zu axes took %lld ms\n", axes.size(), (long long) bringUp.count());
+    fflush(stdout);
+    return failedAxes == 0;
+}
+
+void MountController::shutdown()
+{
+    // called by the owner and again by the destructor, the socket layer is only shut down once
+    if (shutDown) {
+        return;
+    }
+    shutDown = true;
+    for (auto& axis : axes) {
+        axis->shutdown();
+    }
+    socketsShutdown();
+}
+
+AxisHandler& MountController::axis(size_t index)
+{
+    return *axes.at(index);
+}
+
+size_t MountController::axisCount() const
+{
+    return axes.size();
+}
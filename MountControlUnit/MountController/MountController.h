@@ -0,0 +1,47 @@
+/*
+ * MountController.h
+ *
+ *  Created on: 16.10.2026
+ *      Author: morit
+ */
+
+#ifndef MOUNT_CONTROLLER_H_
+#define MOUNT_CONTROLLER_H_
+
+#include <atomic>
+#include <barrier>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AxisHandler.h"
+
+// Owns the axes of the mount. All axes are connected and initialised in parallel, each in its own thread, and
+// start their control cycles together once every axis is ready.
+class MountController {
+
+public:
+    MountController();
+    ~MountController();
+
+    MountController(const MountController&) = delete;
+    MountController& operator=(const MountController&) = delete;
+
+    // Adds an axis before start, the axes are numbered from 1 in the order they are added
+    AxisHandler& addAxis(std::string ipAddress, int port);
+    // Initialises all axes and starts their cycles, returns false if an axis failed, no axis moves in that case
+    bool start();
+    // Stops the cycles of all axes and closes their connections, further calls do nothing until the next start
+    void shutdown();
+
+    AxisHandler& axis(size_t index);
+    size_t axisCount() const;
+
+private:
+    std::vector<std::unique_ptr<AxisHandler>> axes;
+    std::unique_ptr<std::barrier<>> startBarrier;
+    std::atomic<int> failedAxes;
+    bool shutDown;
+};
+
+#endif /* MOUNT_CONTROLLER_H_ */
@@ -1,38 +1,51 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
 
-extern "C"
-{
-  #include "axis_controller.h"
-  #include "thread_utils.h"	
-}
+#include "MountController.h"
 
-#include <iostream>
-#include <thread>
 using namespace std;
 
-int main() {
-    // Create a socket
-    SOCKET socket;
-    char ip_Address[] = "127.0.0.1";
-    int port = 1234;
-    int connectionStatus = createConnection(&socket, ip_Address, port);
-    
-    if (connectionStatus == 0) {
-        // Connection successful, perform desired operation
-        int boardStatus;
-        int status = getSocketStatus(socket, &boardStatus);
-        
-        if (status == 0) {
-            // Successfully retrieved board status
-            // Perform further operations as needed
-        } else {
-            // Error occurred while retrieving board status
+// Usage: MotorControlUnit [ip:port ...], defaults to two boards on 127.0.0.1:1234 and 127.0.0.1:1235
+int main(int argc, char *argv[]) {
+    MountController mount;
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            const char *separator = strchr(argv[i], ':');
+            if (separator == nullptr) {
+                fprintf(stderr, "Usage: %s [ip:port ...]\n", argv[0]);
+                return 1;
+            }
+            mount.addAxis(string(argv[i], separator - argv[i]), atoi(separator + 1));
         }
     } else {
-        // Error occurred while creating connection
+        mount.addAxis("127.0.0.1", 1234);
+        mount.addAxis("127.0.0.1", 1235);
+    }
+
+    if (!mount.start()) {
+        return 1;
     }
-    
-    // Close the socket
-    closesocket(socket);
-    
+
+    // both axes move together for a few seconds and are stopped again
+    for (size_t i = 0; i < mount.axisCount(); i++) {
+        mount.axis(i).moveForward();
+    }
+    for (int second = 0; second < 5; second++) {
+        this_thread::sleep_for(chrono::seconds(1));
+        for (size_t i = 0; i < mount.axisCount(); i++) {
+            printf("Axis %d: %.1f\n", mount.axis(i).getAxleNum(), mount.axis(i).getPosition());
+        }
+        fflush(stdout);
+    }
+    for (size_t i = 0; i < mount.axisCount(); i++) {
+        mount.axis(i).stop();
+    }
+    this_thread::sleep_for(chrono::milliseconds(100));
+    mount.shutdown();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,84 @@
+/**
+ * @file trace_decode.c
+ * @author Moritz Zideck <moritz.zideck@fantana.at>
+ * @date 16.10.2026
+ *
+ * @brief Converts a board trace into CSV
+ *
+ * @details Reads the ring of a trace.bin written by board_trace.c and prints all records from the oldest to the
+ *	newest as CSV, either to stdout or to the given output file.
+ *	Usage: trace_decode <trace.bin> [output.csv]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "board_trace.h"
+
+
+/**
+ * @brief Prints one record as a CSV line
+ * @param output Stream to write to
+ * @param number Sequence number of the record
+ * @param record Record to print
+ */
+static void printRecord(FILE *output, uint64_t number, BoardTraceRecord *record){
+	uint32_t value = 0;
+	for(int i = 0; i < record->size && i < 4; i++){
+		value |= (uint32_t)record->payload[i] << (i * 8);
+	}
+	fprintf(output, "%" PRIu64 ",%" PRIu64 ",%u,0x%06X,%u,%u,%u,%u,%u\n", number, record->timestamp,
+			record->function, record->item, record->size, value, record->rtt, record->retries, record->status);
+}
+
+
+int main(int argc, char *argv[]){
+	BoardTraceHeader header;
+	BoardTraceRecord record;
+	FILE *output = stdout;
+
+	if(argc < 2){
+		fprintf(stderr,"Usage: %s <trace.bin> [output.csv]\n",argv[0]);
+		return EXIT_FAILURE;
+	}
+	FILE *input = fopen(argv[1],"rb");
+	if(input == NULL){
+		fprintf(stderr,"%s couldn't be opened\n",argv[1]);
+		return EXIT_FAILURE;
+	}
+	if(fread(&header, sizeof(header), 1, input) != 1 || header.magic != BOARD_TRACE_MAGIC
+			|| header.version != BOARD_TRACE_VERSION || header.recordSize != sizeof(BoardTraceRecord)
+			|| header.capacity == 0){
+		fprintf(stderr,"%s is no board trace of version %d\n",argv[1],BOARD_TRACE_VERSION);
+		fclose(input);
+		return EXIT_FAILURE;
+	}
+	if(argc > 2){
+		output = fopen(argv[2],"w");
+		if(output == NULL){
+			fprintf(stderr,"%s couldn't be created\n",argv[2]);
+			fclose(input);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// once the ring wrapped around, the oldest record is the one at head
+	uint64_t first = header.head > header.capacity ? header.head - header.capacity : 0;
+	fprintf(output, "number,timestamp_ns,function,item,size,value,rtt_ns,retries,status\n");
+	for(uint64_t number = first; number < header.head; number++){
+		long offset = sizeof(header) + (long)(number % header.capacity) * sizeof(record);
+		if(fseek(input, offset, SEEK_SET) != 0 || fread(&record, sizeof(record), 1, input) != 1){
+			fprintf(stderr,"%s is truncated\n",argv[1]);
+			break;
+		}
+		printRecord(output, number, &record);
+	}
+
+	if(output != stdout){
+		fclose(output);
+	}
+	fclose(input);
+	return EXIT_SUCCESS;
+}